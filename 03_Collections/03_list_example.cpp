@@ -3,6 +3,7 @@
 #include <string>
 #include <algorithm>
 #include <iterator> // For std::advance
+#include "../05_STL/NodePool.h" // PoolAllocator
 
 using namespace std;
 
@@ -141,6 +142,24 @@ int main() {
               << "  - Use when: Frequent random access is needed.\n"
               << "              Insertions/deletions mostly at the end.\n"
               << "              Cache performance is important.\n";
+    cout << endl;
+
+    // ====================================================================
+    // 6. Custom Allocators: Node Pool
+    // ====================================================================
+    std::cout << "--- 6. Custom Allocators: Node Pool ---" << std::endl;
+    // The second template argument of std::list is its allocator. PoolAllocator (05_STL/NodePool.h) serves the
+    // nodes from large slabs, so a push does not call the general purpose allocator and the nodes of the list sit
+    // next to each other in memory, which makes traversal much faster.
+    list<string, PoolAllocator<string>> pooled_planets(planets.begin(), planets.end());
+    pooled_planets.sort();
+    cout << "Pooled planets: "; for(const auto& p : pooled_planets) cout << p << " "; cout << "\n";
+
+    list<int, PoolAllocator<int>> pooled_numbers;
+    for (int n = 0; n < 100000; ++n) pooled_numbers.push_back(n);
+    NodePoolStats stats = nodePoolStats();
+    cout << "The " << pooled_planets.size() + pooled_numbers.size() << " pooled nodes came from " << stats.slabs
+         << " slabs instead of one allocation each" << endl;
 
     return 0;
 }
@@ -193,4 +212,8 @@ std::vector (Dynamic Array):
   - Use when: Frequent random access is needed.
               Insertions/deletions mostly at the end.
               Cache performance is important.
+
+--- 6. Custom Allocators: Node Pool ---
+Pooled planets: Ceres Earth Eris Mars Pluto Saturn Uranus Venus 
+The 100008 pooled nodes came from 38 slabs instead of one allocation each
 */
\ No newline at end of file
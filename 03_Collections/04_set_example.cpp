@@ -3,6 +3,7 @@
 #include <algorithm> // For std::set_union, std::set_intersection, etc.
 #include <vector>    // For initializing set from a vector
 #include <iterator>  // For std::inserter
+#include "../05_STL/EytzingerSet.h" // EytzingerSet
 
 // Custom struct for set example
 struct Point {
@@ -296,6 +297,20 @@ int main() {
     std::cout << "Is B a subset of A? "
               << (std::includes(sA.begin(), sA.end(), sB.begin(), sB.end()) ? "Yes" : "No")
               << std::endl;
+    std::cout << std::endl;
+
+    // ====================================================================
+    // 7. Static Sets: Eytzinger Layout
+    // ====================================================================
+    std::cout << "--- 7. Static Sets: Eytzinger Layout ---" << std::endl;
+    // A set that is built once and then only queried does not need a tree. EytzingerSet (05_STL/EytzingerSet.h)
+    // keeps the values in one array in the order of a binary heap and answers the same queries as std::set, several
+    // times faster once the set no longer fits in the cache.
+    EytzingerSet<int> staticSet(sUnion.begin(), sUnion.end());
+    std::cout << "Static set: "; for (int x : staticSet) std::cout << x << " "; std::cout << "\n";
+    std::cout << "Contains 6? " << (staticSet.contains(6) ? "Yes" : "No")
+              << ", lower_bound(0) is " << *staticSet.lower_bound(0)
+              << ", upper_bound(6) is " << *staticSet.upper_bound(6) << std::endl;
 
     return 0;
 }
@@ -352,4 +367,8 @@ Difference (A - B): 1 2 3
 Symmetric Difference: 1 2 3 6 7 8 
 Is {2, 3} a subset of A? Yes
 Is B a subset of A? No
+
+--- 7. Static Sets: Eytzinger Layout ---
+Static set: 1 2 3 4 5 6 7 8 
+Contains 6? Yes, lower_bound(0) is 1, upper_bound(6) is 7
 */
\ No newline at end of file
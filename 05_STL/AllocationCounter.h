@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h> // _aligned_malloc, _aligned_free
+#endif
+
+// Replaces the global operator new and delete with versions that count what is requested, so a benchmark can show
+// how often a container allocates (allocations) and how much (allocatedBytes). The memory still comes from malloc;
+// the aligned forms (used by NodePool's slabs and Eytzinger's cache-line allocator) come from aligned_alloc, or
+// from _aligned_malloc on Windows, whose runtime has no std::aligned_alloc and wants _aligned_free back.
+//
+// Replacement allocation functions cannot be inline, so include this header in exactly one translation unit of a
+// program: the example's own .cpp file. The deletes are noinline because GCC 12, seeing free() inlined where a
+// new-expression's pointer is released, reports a false -Wmismatched-new-delete.
+//
+// In C#, GC.GetAllocatedBytesForCurrentThread() gives the byte count without replacing anything.
+
+inline std::atomic<std::size_t> allocations{0};
+inline std::atomic<std::size_t> allocatedBytes{0};
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    allocatedBytes += size;
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    ++allocations;
+    allocatedBytes += size;
+    const auto alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    void* pointer = _aligned_malloc(size ? size : 1, alignment);
+#else
+    void* pointer = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    if (pointer) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* pointer) noexcept { std::free(pointer); }
+[[gnu::noinline]] void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+[[gnu::noinline]] void operator delete(void* pointer, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+[[gnu::noinline]] void operator delete(void* pointer, std::size_t, std::align_val_t align) noexcept {
+    operator delete(pointer, align);
+}
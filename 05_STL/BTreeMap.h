@@ -0,0 +1,511 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Ordered map stored as a B+ tree.
+//
+// NoobMap (map_example_noob.cpp) keeps at most 100 pairs in a fixed array and searches it linearly. std::map is a
+// red-black tree: one heap node per element, and a lookup in a million keys follows about 20 pointers, each one a
+// likely cache miss. BTreeMap packs many keys into each node:
+//
+// - A node is about NodeBytes (default 256 bytes, four cache lines) of keys, so a million keys need only 3 or 4
+//   levels, and the keys of a node are searched in memory that is already loaded.
+// - All elements live in the leaves, which are linked in order: iteration walks arrays, not tree pointers.
+// - Inner nodes only hold separator keys: every key in children[i + 1] is >= keys[i], every key in children[i] is
+//   below it.
+// - bulkLoad() builds the tree bottom-up from sorted input in O(N), with full leaves.
+// - erase() frees a node when it becomes empty but does not merge half-empty neighbours (like many database
+//   B-trees). Lookups stay correct; a tree that had most of its keys erased is just less dense until rebuilt.
+//
+// Key and Value must be default-constructible (node arrays are allocated up front). Iterators yield
+// std::pair<const Key&, Value&>; inserting or erasing invalidates them.
+//
+// In C#, this is SortedDictionary<TKey, TValue> (a red-black tree, like std::map) done the cache-friendly way.
+
+template <typename Key, typename Value, typename Compare = std::less<Key>, std::size_t NodeBytes = 256>
+class BTreeMap {
+    static constexpr std::size_t leafSlots = std::max<std::size_t>(4, NodeBytes / (sizeof(Key) + sizeof(Value)));
+    static constexpr std::size_t innerSlots = std::max<std::size_t>(4, NodeBytes / (sizeof(Key) + sizeof(void*)));
+
+    struct Node {
+        explicit Node(bool leaf) : leaf(leaf) {}
+        bool leaf;
+        std::size_t count = 0; // Keys in use
+    };
+
+    struct Leaf : Node {
+        Leaf() : Node(true) {}
+        Key keys[leafSlots];
+        Value values[leafSlots];
+        Leaf* previous = nullptr;
+        Leaf* next = nullptr;
+    };
+
+    struct Inner : Node {
+        Inner() : Node(false) {}
+        Key keys[innerSlots];
+        Node* children[innerSlots + 1];
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using reference = std::pair<const Key&, Value&>;
+    using const_reference = std::pair<const Key&, const Value&>;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using value_type = std::pair<const Key, Value>;
+        using reference = std::conditional_t<Const, BTreeMap::const_reference, BTreeMap::reference>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        // it->second needs a pointer; the pair of references lives in the proxy
+        struct pointer {
+            reference pair;
+            const reference* operator->() const { return &pair; }
+        };
+
+        Iterator() = default;
+        Iterator(Leaf* leaf, std::size_t index, const BTreeMap* map) : leaf(leaf), index(index), map(map) {}
+        operator Iterator<true>() const
+            requires(!Const)
+        {
+            return Iterator<true>(leaf, index, map);
+        }
+
+        reference operator*() const { return {leaf->keys[index], leaf->values[index]}; }
+        pointer operator->() const { return pointer{**this}; }
+
+        Iterator& operator++() {
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        Iterator& operator--() {
+            if (!leaf) {
+                leaf = map->lastLeaf; // --end()
+                index = leaf->count - 1;
+            } else if (index == 0) {
+                leaf = leaf->previous;
+                index = leaf->count - 1;
+            } else {
+                --index;
+            }
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const { return leaf == other.leaf && index == other.index; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class BTreeMap;
+
+        Leaf* leaf = nullptr; // nullptr is end()
+        std::size_t index = 0;
+        const BTreeMap* map = nullptr;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    BTreeMap() = default;
+    BTreeMap(const BTreeMap&) = delete;
+    BTreeMap& operator=(const BTreeMap&) = delete;
+
+    BTreeMap(BTreeMap&& other) noexcept { swap(other); }
+
+    BTreeMap& operator=(BTreeMap&& other) noexcept {
+        BTreeMap old(std::move(*this));
+        swap(other);
+        return *this;
+    }
+
+    ~BTreeMap() { destroy(root); }
+
+    void swap(BTreeMap& other) noexcept {
+        std::swap(root, other.root);
+        std::swap(firstLeaf, other.firstLeaf);
+        std::swap(lastLeaf, other.lastLeaf);
+        std::swap(count, other.count);
+        std::swap(depth, other.depth);
+        std::swap(less, other.less);
+    }
+
+    // Build from pairs sorted by key with no duplicates, replacing the current contents. O(N).
+    template <typename It>
+    void bulkLoad(It first, It last) {
+        BTreeMap built;
+        built.less = less;
+        std::vector<Node*> level;
+        Leaf* previous = nullptr;
+        for (; first != last; ++first) {
+            if (!previous || previous->count == leafSlots) {
+                Leaf* leaf = new Leaf;
+                leaf->previous = previous;
+                if (previous) {
+                    previous->next = leaf;
+                } else {
+                    built.firstLeaf = leaf;
+                }
+                level.push_back(leaf);
+                previous = leaf;
+            }
+            previous->keys[previous->count] = first->first;
+            previous->values[previous->count] = first->second;
+            ++previous->count;
+            ++built.count;
+        }
+        built.lastLeaf = previous;
+        // Each pass groups up to innerSlots + 1 nodes under a new parent, until one node is left
+        built.depth = 1;
+        while (level.size() > 1) {
+            std::vector<Node*> parents;
+            for (std::size_t i = 0; i < level.size(); i += innerSlots + 1) {
+                Inner* parent = new Inner;
+                const std::size_t end = std::min(level.size(), i + innerSlots + 1);
+                parent->children[0] = level[i];
+                for (std::size_t j = i + 1; j < end; ++j) {
+                    parent->keys[parent->count] = smallestKey(level[j]);
+                    parent->children[++parent->count] = level[j];
+                }
+                parents.push_back(parent);
+            }
+            level.swap(parents);
+            ++built.depth;
+        }
+        built.root = level.empty() ? nullptr : level.front();
+        built.depth = level.empty() ? 0 : built.depth;
+        swap(built);
+    }
+
+    iterator begin() { return iterator(firstLeaf, 0, this); }
+    iterator end() { return iterator(nullptr, 0, this); }
+    const_iterator begin() const { return const_iterator(firstLeaf, 0, this); }
+    const_iterator end() const { return const_iterator(nullptr, 0, this); }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::size_t height() const { return depth; }
+
+    void clear() {
+        BTreeMap empty;
+        empty.less = less;
+        swap(empty);
+    }
+
+    iterator find(const Key& key) {
+        auto [leaf, index] = leafLowerBound(key);
+        return leaf && index < leaf->count && !less(key, leaf->keys[index]) ? iterator(leaf, index, this) : end();
+    }
+
+    const_iterator find(const Key& key) const { return const_cast<BTreeMap*>(this)->find(key); }
+    bool contains(const Key& key) const { return find(key) != end(); }
+
+    Value& at(const Key& key) {
+        auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("BTreeMap::at: key not found");
+        }
+        return it->second;
+    }
+
+    // First element with a key >= key
+    iterator lower_bound(const Key& key) {
+        auto [leaf, index] = leafLowerBound(key);
+        return normalize(leaf, index);
+    }
+
+    // First element with a key > key
+    iterator upper_bound(const Key& key) {
+        if (!root) {
+            return end();
+        }
+        Leaf* leaf = descend(key);
+        const std::size_t index = static_cast<std::size_t>(
+            std::upper_bound(leaf->keys, leaf->keys + leaf->count, key, less) - leaf->keys);
+        return normalize(leaf, index);
+    }
+
+    const_iterator lower_bound(const Key& key) const { return const_cast<BTreeMap*>(this)->lower_bound(key); }
+    const_iterator upper_bound(const Key& key) const { return const_cast<BTreeMap*>(this)->upper_bound(key); }
+
+    // Calls f(key, value) for every element with from <= key < to, in order
+    template <typename F>
+    void forEachInRange(const Key& from, const Key& to, F&& f) const {
+        auto [leaf, index] = const_cast<BTreeMap*>(this)->leafLowerBound(from);
+        for (; leaf; leaf = leaf->next, index = 0) {
+            for (; index < leaf->count; ++index) {
+                if (!less(leaf->keys[index], to)) {
+                    return;
+                }
+                f(leaf->keys[index], leaf->values[index]);
+            }
+        }
+    }
+
+    // Inserts Value(args...) if key is absent; returns the element and whether it was inserted
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        if (!root) {
+            Leaf* leaf = new Leaf;
+            root = firstLeaf = lastLeaf = leaf;
+            depth = 1;
+        }
+        // Remember the path so splits can be pushed up to the parents
+        Inner* path[64];
+        std::size_t childIndex[64];
+        std::size_t level = 0;
+        Node* node = root;
+        while (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            const std::size_t i = childFor(inner, key);
+            path[level] = inner;
+            childIndex[level++] = i;
+            node = inner->children[i];
+        }
+        Leaf* leaf = static_cast<Leaf*>(node);
+        std::size_t index =
+            static_cast<std::size_t>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, less) - leaf->keys);
+        if (index < leaf->count && !less(key, leaf->keys[index])) {
+            return {iterator(leaf, index, this), false};
+        }
+
+        if (leaf->count == leafSlots) {
+            // Split the full leaf in half and put the new key into the half where it belongs
+            Leaf* right = new Leaf;
+            const std::size_t half = leafSlots / 2;
+            std::move(leaf->keys + half, leaf->keys + leafSlots, right->keys);
+            std::move(leaf->values + half, leaf->values + leafSlots, right->values);
+            right->count = leafSlots - half;
+            leaf->count = half;
+            right->next = leaf->next;
+            right->previous = leaf;
+            (leaf->next ? leaf->next->previous : lastLeaf) = right;
+            leaf->next = right;
+            insertIntoParents(path, childIndex, level, right->keys[0], right);
+            if (index > half) {
+                leaf = right;
+                index -= half;
+            }
+        }
+        std::move_backward(leaf->keys + index, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + index, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[index] = key;
+        leaf->values[index] = Value(std::forward<Args>(args)...);
+        ++leaf->count;
+        ++count;
+        return {iterator(leaf, index, this), true};
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second) {
+            result.first->second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    // Returns the number of elements removed (0 or 1)
+    std::size_t erase(const Key& key) {
+        if (!root) {
+            return 0;
+        }
+        Inner* path[64];
+        std::size_t childIndex[64];
+        std::size_t level = 0;
+        Node* node = root;
+        while (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            const std::size_t i = childFor(inner, key);
+            path[level] = inner;
+            childIndex[level++] = i;
+            node = inner->children[i];
+        }
+        Leaf* leaf = static_cast<Leaf*>(node);
+        const std::size_t index =
+            static_cast<std::size_t>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, less) - leaf->keys);
+        if (index == leaf->count || less(key, leaf->keys[index])) {
+            return 0;
+        }
+        std::move(leaf->keys + index + 1, leaf->keys + leaf->count, leaf->keys + index);
+        std::move(leaf->values + index + 1, leaf->values + leaf->count, leaf->values + index);
+        --leaf->count;
+        --count;
+        if (leaf->count == 0) {
+            (leaf->previous ? leaf->previous->next : firstLeaf) = leaf->next;
+            (leaf->next ? leaf->next->previous : lastLeaf) = leaf->previous;
+            removeEmptyNode(path, childIndex, level, leaf);
+        }
+        return 1;
+    }
+
+private:
+    std::size_t childFor(const Inner* inner, const Key& key) const {
+        return static_cast<std::size_t>(
+            std::upper_bound(inner->keys, inner->keys + inner->count, key, less) - inner->keys);
+    }
+
+    Leaf* descend(const Key& key) const {
+        Node* node = root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            node = inner->children[childFor(inner, key)];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    std::pair<Leaf*, std::size_t> leafLowerBound(const Key& key) {
+        if (!root) {
+            return {nullptr, 0};
+        }
+        Leaf* leaf = descend(key);
+        return {leaf, static_cast<std::size_t>(
+                          std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, less) - leaf->keys)};
+    }
+
+    // Past the last key of a leaf means the first key of the next one
+    iterator normalize(Leaf* leaf, std::size_t index) {
+        if (leaf && index == leaf->count) {
+            return iterator(leaf->next, 0, this);
+        }
+        return iterator(leaf, index, this);
+    }
+
+    static const Key& smallestKey(const Node* node) {
+        while (!node->leaf) {
+            node = static_cast<const Inner*>(node)->children[0];
+        }
+        return static_cast<const Leaf*>(node)->keys[0];
+    }
+
+    // Add separator/right as the neighbour after the child we came from, splitting full parents on the way up
+    void insertIntoParents(Inner** path, std::size_t* childIndex, std::size_t level, Key separator, Node* right) {
+        while (level > 0) {
+            Inner* parent = path[--level];
+            const std::size_t i = childIndex[level];
+            if (parent->count < innerSlots) {
+                std::move_backward(parent->keys + i, parent->keys + parent->count, parent->keys + parent->count + 1);
+                std::move_backward(parent->children + i + 1, parent->children + parent->count + 1,
+                                   parent->children + parent->count + 2);
+                parent->keys[i] = std::move(separator);
+                parent->children[i + 1] = right;
+                ++parent->count;
+                return;
+            }
+            // Full: lay out the innerSlots + 1 keys and innerSlots + 2 children in order, then split around the
+            // middle key, which moves up instead of staying in either half
+            Key keys[innerSlots + 1];
+            Node* children[innerSlots + 2];
+            std::move(parent->keys, parent->keys + i, keys);
+            keys[i] = std::move(separator);
+            std::move(parent->keys + i, parent->keys + innerSlots, keys + i + 1);
+            std::copy(parent->children, parent->children + i + 1, children);
+            children[i + 1] = right;
+            std::copy(parent->children + i + 1, parent->children + innerSlots + 1, children + i + 2);
+
+            const std::size_t middle = (innerSlots + 1) / 2;
+            Inner* sibling = new Inner;
+            parent->count = middle;
+            std::move(keys, keys + middle, parent->keys);
+            std::copy(children, children + middle + 1, parent->children);
+            sibling->count = innerSlots - middle;
+            std::move(keys + middle + 1, keys + innerSlots + 1, sibling->keys);
+            std::copy(children + middle + 1, children + innerSlots + 2, sibling->children);
+            separator = std::move(keys[middle]);
+            right = sibling;
+        }
+        // The root itself split: grow the tree by one level
+        Inner* newRoot = new Inner;
+        newRoot->keys[0] = std::move(separator);
+        newRoot->children[0] = root;
+        newRoot->children[1] = right;
+        newRoot->count = 1;
+        root = newRoot;
+        ++depth;
+    }
+
+    // Unhook an empty node from its parent; parents left without children go too, and a root with a single child
+    // is replaced by that child
+    void removeEmptyNode(Inner** path, std::size_t* childIndex, std::size_t level, Node* empty) {
+        while (level > 0) {
+            freeNode(empty);
+            Inner* parent = path[--level];
+            const std::size_t i = childIndex[level];
+            if (parent->count == 0) {
+                empty = parent; // Its only child is gone
+                continue;
+            }
+            // Drop child i together with the separator next to it
+            const std::size_t keyIndex = i == 0 ? 0 : i - 1;
+            std::move(parent->keys + keyIndex + 1, parent->keys + parent->count, parent->keys + keyIndex);
+            std::copy(parent->children + i + 1, parent->children + parent->count + 1, parent->children + i);
+            --parent->count;
+            while (!root->leaf && root->count == 0) {
+                Inner* oldRoot = static_cast<Inner*>(root);
+                root = oldRoot->children[0];
+                delete oldRoot;
+                --depth;
+            }
+            return;
+        }
+        freeNode(empty); // The root leaf itself is empty: the tree is empty
+        root = firstLeaf = lastLeaf = nullptr;
+        depth = 0;
+    }
+
+    // Just this node, not its children
+    static void freeNode(Node* node) {
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+        } else {
+            delete static_cast<Inner*>(node);
+        }
+    }
+
+    static void destroy(Node* node) {
+        if (!node) {
+            return;
+        }
+        if (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            for (std::size_t i = 0; i <= inner->count; ++i) {
+                destroy(inner->children[i]);
+            }
+        }
+        freeNode(node);
+    }
+
+    Node* root = nullptr;
+    Leaf* firstLeaf = nullptr;
+    Leaf* lastLeaf = nullptr;
+    std::size_t count = 0;
+    std::size_t depth = 0;
+    Compare less;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+// Timing helper shared by the benchmark examples.
+//
+// In C#, this is a Stopwatch around the loop, divided by the operation count.
+
+// Runs f() once and returns the wall-clock time per operation in nanoseconds, for f doing `operations` operations
+template <typename F>
+double nanosPer(std::size_t operations, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(operations);
+}
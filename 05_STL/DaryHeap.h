@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Indexed d-ary heap: a priority queue whose elements can be changed or removed after they were pushed.
+//
+// NoobPriorityQueue (priority_queue_example_noob.cpp) and std::priority_queue are binary heaps that can only push
+// and pop. Algorithms like Dijkstra's shortest paths or a timer/scheduler queue also need to lower a priority or
+// cancel an entry that is already queued. Without that they push duplicates and skip stale entries when popped,
+// so the heap grows with every update. DaryHeap supports these operations directly:
+//
+// - push() returns a Handle. update(handle, value) moves the element up or down to its new place and
+//   erase(handle) removes it, both in O(log n). A position table, indexed by handle, says where each element is.
+// - Each node has Arity children instead of 2. The heap is flatter (log_d n levels), so a push or an update that
+//   moves an element towards the top touches fewer levels. A pop compares d children per level, but these sit
+//   next to each other in memory: with d = 4 or 8 they share one or two cache lines. For large heaps d = 4 is
+//   usually faster than a binary heap.
+// - Elements are moved into a hole instead of swapped at every level, which halves the number of writes.
+//
+// The handles are not free: every move also writes the position table, at a place unrelated to the heap index.
+// For plain push/pop DaryHeap is therefore slower than std::priority_queue; it pays off when elements are updated
+// or cancelled, because the heap then holds each element once instead of collecting stale duplicates.
+//
+// Like std::priority_queue, top() is the largest element under Compare (std::less gives a max-heap, std::greater a
+// min-heap). A handle is valid until its element is popped or erased; the number may then be reused by a later push.
+//
+// In C#, PriorityQueue<TElement, TPriority> is a 4-ary heap, but it has no handles to update or remove an element.
+template <typename T, std::size_t Arity = 4, typename Compare = std::less<T>>
+class DaryHeap {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+public:
+    using Handle = std::size_t;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    DaryHeap() = default;
+    explicit DaryHeap(const Compare& compare) : compare(compare) {}
+
+    bool empty() const { return heap.empty(); }
+    size_type size() const { return heap.size(); }
+
+    void reserve(size_type capacity) {
+        heap.reserve(capacity);
+        positions.reserve(capacity);
+    }
+
+    void clear() {
+        heap.clear();
+        positions.clear();
+        freeHandles.clear();
+    }
+
+    const T& top() const {
+        if (heap.empty()) {
+            throw std::out_of_range("DaryHeap::top: heap is empty");
+        }
+        return heap.front().value;
+    }
+
+    Handle topHandle() const {
+        if (heap.empty()) {
+            throw std::out_of_range("DaryHeap::topHandle: heap is empty");
+        }
+        return heap.front().handle;
+    }
+
+    Handle push(T value) {
+        Handle handle;
+        if (freeHandles.empty()) {
+            handle = positions.size();
+            positions.push_back(0);
+        } else {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        heap.push_back({std::move(value), handle});
+        siftUp(heap.size() - 1);
+        return handle;
+    }
+
+    void pop() {
+        if (heap.empty()) {
+            throw std::out_of_range("DaryHeap::pop: heap is empty");
+        }
+        removeAt(0);
+    }
+
+    // Removes the top element and returns it
+    T extractTop() {
+        if (heap.empty()) {
+            throw std::out_of_range("DaryHeap::extractTop: heap is empty");
+        }
+        T value = std::move(heap.front().value);
+        removeAt(0);
+        return value;
+    }
+
+    bool contains(Handle handle) const { return handle < positions.size() && positions[handle] != removed; }
+
+    const T& value(Handle handle) const { return heap[checkedPosition(handle)].value; }
+
+    // Replaces the element and restores the heap order, whichever way the priority changed
+    void update(Handle handle, T value) {
+        const size_type position = checkedPosition(handle);
+        const bool raised = compare(heap[position].value, value);
+        heap[position].value = std::move(value);
+        if (raised) {
+            siftUp(position);
+        } else {
+            siftDown(position);
+        }
+    }
+
+    void erase(Handle handle) { removeAt(checkedPosition(handle)); }
+
+private:
+    struct Entry {
+        T value;
+        Handle handle;
+    };
+
+    static constexpr size_type removed = std::numeric_limits<size_type>::max();
+
+    std::vector<Entry> heap;
+    std::vector<size_type> positions; // positions[handle] is the index of the element in heap, or removed
+    std::vector<Handle> freeHandles;
+    [[no_unique_address]] Compare compare;
+
+    size_type checkedPosition(Handle handle) const {
+        if (!contains(handle)) {
+            throw std::out_of_range("DaryHeap: invalid handle");
+        }
+        return positions[handle];
+    }
+
+    void place(size_type index, Entry&& entry) {
+        positions[entry.handle] = index;
+        heap[index] = std::move(entry);
+    }
+
+    void removeAt(size_type index) {
+        const Handle handle = heap[index].handle;
+        positions[handle] = removed;
+        freeHandles.push_back(handle);
+        const size_type last = heap.size() - 1;
+        if (index != last) {
+            // The last element fills the gap and goes up if it beats its new parent, down otherwise. The removed
+            // value is never compared: extractTop() has already moved it out.
+            heap[index] = std::move(heap[last]);
+            positions[heap[index].handle] = index;
+            heap.pop_back();
+            if (index > 0 && compare(heap[(index - 1) / Arity].value, heap[index].value)) {
+                siftUp(index);
+            } else {
+                siftDown(index);
+            }
+        } else {
+            heap.pop_back();
+        }
+    }
+
+    void siftUp(size_type index) {
+        Entry entry = std::move(heap[index]);
+        while (index > 0) {
+            const size_type parent = (index - 1) / Arity;
+            if (!compare(heap[parent].value, entry.value)) {
+                break;
+            }
+            place(index, std::move(heap[parent]));
+            index = parent;
+        }
+        place(index, std::move(entry));
+    }
+
+    void siftDown(size_type index) {
+        const size_type size = heap.size();
+        Entry entry = std::move(heap[index]);
+        while (true) {
+            const size_type first = index * Arity + 1;
+            if (first >= size) {
+                break;
+            }
+            // Largest of the (up to) Arity children, which are adjacent in memory
+            size_type best = first;
+            const size_type end = first + Arity < size ? first + Arity : size;
+            for (size_type child = first + 1; child < end; ++child) {
+                if (compare(heap[best].value, heap[child].value)) {
+                    best = child;
+                }
+            }
+            if (!compare(entry.value, heap[best].value)) {
+                break;
+            }
+            place(index, std::move(heap[best]));
+            index = best;
+        }
+        place(index, std::move(entry));
+    }
+};
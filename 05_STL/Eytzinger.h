@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include "Prefetch.h"
+
+// The Eytzinger (breadth-first) layout shared by EytzingerSet and FlatMultiMap's index.
+//
+// A sorted sequence of n values is stored in slots 1..n in the order of a binary heap: slot 1 is the root and the
+// children of slot k are 2k and 2k + 1 (slot 0 is unused). A search walks k = 2k + (slot[k] < key) without a
+// branch, and the first levels of every search share the same few cache lines.
+//
+// - layout() says which slot receives which rank of the sorted input.
+// - search() runs the descent, optionally prefetching prefetchLevels<T> levels ahead: the 2^d descendants of slot k
+//   d levels down are the adjacent slots k * 2^d .. k * 2^d + 2^d - 1, so with d chosen to make them fill one cache
+//   line (4 levels for 4-byte keys, 1 level for 32-byte keys) a single prefetch covers wherever the search goes.
+// - CacheLineAllocator aligns the slot array so those blocks do not straddle two cache lines.
+//
+// In C#, there is no equivalent; the layout is a sorted array permuted once, searched with the same loop.
+namespace eytzinger {
+
+constexpr std::size_t cacheLineBytes = 64;
+
+// Allocates on a cache-line boundary, for the slot array
+template <typename U>
+struct CacheLineAllocator {
+    using value_type = U;
+    CacheLineAllocator() = default;
+    template <typename V>
+    CacheLineAllocator(const CacheLineAllocator<V>&) noexcept {}
+    U* allocate(std::size_t n) {
+        return static_cast<U*>(::operator new(n * sizeof(U), std::align_val_t{cacheLineBytes}));
+    }
+    void deallocate(U* pointer, std::size_t) noexcept { ::operator delete(pointer, std::align_val_t{cacheLineBytes}); }
+    bool operator==(const CacheLineAllocator&) const noexcept { return true; }
+};
+
+template <typename T>
+constexpr std::size_t slotsPerLine = std::max<std::size_t>(1, cacheLineBytes / sizeof(T));
+
+// Levels to prefetch ahead: as many as fit their descendants in one cache line, but at least one
+template <typename T>
+constexpr int prefetchLevels = std::max(1, static_cast<int>(std::bit_width(slotsPerLine<T>)) - 1);
+
+namespace detail {
+
+template <typename Place>
+void layout(std::size_t n, std::size_t slot, std::size_t& rank, Place& place) {
+    if (slot > n) {
+        return;
+    }
+    layout(n, 2 * slot, rank, place);
+    place(slot, rank++);
+    layout(n, 2 * slot + 1, rank, place);
+}
+
+} // namespace detail
+
+// Calls place(slot, rank) for ranks 0..n-1 of the sorted input: an in-order walk of the implicit tree
+template <typename Place>
+void layout(std::size_t n, Place place) {
+    std::size_t rank = 0;
+    detail::layout(n, 1, rank, place);
+}
+
+// Slot (1..n) of the first value for which goRight(value) is false, or 0 if there is none; goRight must be true for
+// a prefix of the sorted order
+template <bool Prefetch = true, typename T, typename GoRight>
+std::size_t search(const T* slots, std::size_t n, GoRight goRight) {
+    std::size_t k = 1;
+    while (k <= n) {
+        if constexpr (Prefetch) {
+            const std::size_t first = k << prefetchLevels<T>;
+            prefetchRead(slots + std::min(first, n));
+            if constexpr (sizeof(T) > cacheLineBytes) {
+                // One level ahead, and the two children do not share a cache line
+                prefetchRead(slots + std::min(first + 1, n));
+            }
+        }
+        k = 2 * k + static_cast<std::size_t>(goRight(slots[k]));
+    }
+    // Going right means "before the answer"; undo the right turns made after the last left turn, and that one
+    return k >> (std::countr_one(k) + 1);
+}
+
+} // namespace eytzinger
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "Eytzinger.h"
+
+// Static sorted set stored in Eytzinger (breadth-first) order, for membership and range queries on data that rarely
+// changes.
+//
+// std::set is a red-black tree: a lookup follows about log2(N) pointers to nodes scattered over the heap. A binary
+// search over a sorted vector touches the same number of elements, but its first probes (N/2, N/4, 3N/4, ...) are
+// far apart, each one a cache miss once the array is larger than the cache, and whether it goes left or right is a
+// branch the CPU cannot predict. EytzingerSet stores the sorted values in the order of a binary heap:
+//
+// - The root is slot 1 and the children of slot k are 2k and 2k + 1, so a search walks k = 2k + (slot[k] < key),
+//   without a branch. The slots a search can reach d levels further down are 2^d adjacent elements: the search
+//   prefetches them while it compares the current level, with d chosen so they fill one cache line (4 levels for
+//   4-byte keys, fewer for larger ones), so the memory latency of several levels overlaps. The layout, search and
+//   prefetch distance are in Eytzinger.h, shared with FlatMultiMap's index.
+// - With Prefetch = false the same layout is searched without prefetching, to show what each part contributes.
+// - lower_bound(), upper_bound(), find(), contains(), count() and equal_range() answer like std::set. Iteration is in
+//   sorted order (an in-order walk of the implicit tree), so ranges from lower_bound() can be iterated.
+// - The set is built once from values in any order (duplicates are dropped) and cannot be modified afterwards; to
+//   change it, build a new one.
+//
+// branchlessLowerBound() is the other half: std::lower_bound over an ordinary sorted range, with the comparison
+// turned into a conditional move.
+//
+// In C#, the nearest is a sorted array with Array.BinarySearch, or ImmutableSortedSet<T> (a tree).
+
+// std::lower_bound without an unpredictable branch: the range halves every step whatever the comparisons say
+template <typename It, typename T, typename Compare = std::less<>>
+It branchlessLowerBound(It first, It last, const T& value, Compare less = Compare()) {
+    auto n = last - first;
+    if (n == 0) {
+        return first;
+    }
+    while (n > 1) {
+        const auto half = n / 2;
+        first = less(first[half], value) ? first + half : first;
+        n -= half;
+    }
+    return first + less(*first, value);
+}
+
+template <typename T, typename Compare = std::less<T>, bool Prefetch = true>
+class EytzingerSet {
+public:
+    using value_type = T;
+    using key_type = T;
+    using size_type = std::size_t;
+
+    // Visits the slots in sorted order; slot 0 is end()
+    class const_iterator {
+    public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() = default;
+        const_iterator(const EytzingerSet* set, std::size_t slot) : set(set), slot(slot) {}
+
+        reference operator*() const { return set->slots[slot]; }
+        pointer operator->() const { return &set->slots[slot]; }
+
+        const_iterator& operator++() {
+            slot = set->next(slot);
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        const_iterator& operator--() {
+            slot = set->previous(slot);
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const { return slot == other.slot; }
+
+    private:
+        const EytzingerSet* set = nullptr;
+        std::size_t slot = 0;
+    };
+
+    using iterator = const_iterator;
+
+    explicit EytzingerSet(Compare less = Compare()) : slots(1), less(std::move(less)) {}
+
+    // Build from values in any order; duplicates are dropped. O(N log N).
+    template <typename It>
+    EytzingerSet(It first, It last, Compare less = Compare()) : less(std::move(less)) {
+        std::vector<T> sorted(first, last);
+        std::sort(sorted.begin(), sorted.end(), this->less);
+        sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                                 [this](const T& a, const T& b) { return !this->less(a, b) && !this->less(b, a); }),
+                     sorted.end());
+        slots.resize(sorted.size() + 1);
+        eytzinger::layout(sorted.size(),
+                          [&](std::size_t slot, std::size_t rank) { slots[slot] = std::move(sorted[rank]); });
+    }
+
+    EytzingerSet(std::initializer_list<T> values, Compare less = Compare())
+        : EytzingerSet(values.begin(), values.end(), std::move(less)) {}
+
+    bool empty() const { return slots.size() == 1; }
+    size_type size() const { return slots.size() - 1; }
+
+    const_iterator begin() const { return const_iterator(this, leftmost(1)); }
+    const_iterator end() const { return const_iterator(this, 0); }
+
+    // First value not less than key
+    const_iterator lower_bound(const T& key) const {
+        return const_iterator(this, search(key, [this](const T& slot, const T& k) { return less(slot, k); }));
+    }
+
+    // First value greater than key
+    const_iterator upper_bound(const T& key) const {
+        return const_iterator(this, search(key, [this](const T& slot, const T& k) { return !less(k, slot); }));
+    }
+
+    const_iterator find(const T& key) const {
+        const const_iterator it = lower_bound(key);
+        return it != end() && !less(key, *it) ? it : end();
+    }
+
+    bool contains(const T& key) const { return find(key) != end(); }
+    size_type count(const T& key) const { return contains(key) ? 1 : 0; }
+
+    std::pair<const_iterator, const_iterator> equal_range(const T& key) const {
+        const const_iterator first = lower_bound(key);
+        if (first == end() || less(key, *first)) {
+            return {first, first};
+        }
+        return {first, std::next(first)};
+    }
+
+    // Bytes of the slot array
+    size_type memoryBytes() const { return slots.capacity() * sizeof(T); }
+
+private:
+    std::vector<T, eytzinger::CacheLineAllocator<T>> slots;
+    Compare less;
+
+    // Slot of the first value for which goRight is false, or 0 if there is none
+    template <typename GoRight>
+    std::size_t search(const T& key, GoRight goRight) const {
+        return eytzinger::search<Prefetch>(slots.data(), slots.size() - 1,
+                                           [&](const T& slot) { return goRight(slot, key); });
+    }
+
+    std::size_t leftmost(std::size_t slot) const {
+        if (slot >= slots.size()) {
+            return 0;
+        }
+        while (2 * slot < slots.size()) {
+            slot = 2 * slot;
+        }
+        return slot;
+    }
+
+    std::size_t rightmost(std::size_t slot) const {
+        if (slot >= slots.size()) {
+            return 0;
+        }
+        while (2 * slot + 1 < slots.size()) {
+            slot = 2 * slot + 1;
+        }
+        return slot;
+    }
+
+    // In-order successor: the leftmost slot of the right subtree, or the first ancestor reached from its left
+    std::size_t next(std::size_t slot) const {
+        if (2 * slot + 1 < slots.size()) {
+            return leftmost(2 * slot + 1);
+        }
+        return slot >> (std::countr_one(slot) + 1);
+    }
+
+    // In-order predecessor; --end() is the largest value
+    std::size_t previous(std::size_t slot) const {
+        if (slot == 0) {
+            return rightmost(1);
+        }
+        if (2 * slot < slots.size()) {
+            return rightmost(2 * slot);
+        }
+        return slot >> (std::countr_zero(slot) + 1);
+    }
+};
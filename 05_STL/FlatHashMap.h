@@ -0,0 +1,490 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// MSVC does not define __SSE2__, but SSE2 is always there on x64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // _umul128
+#endif
+
+// Open-addressing hash map in the style of SwissTable (Abseil's flat_hash_map).
+//
+// NoobHashMap (unordered_map_example_noob.cpp) compares the key with every stored pair: O(N) per operation.
+// std::unordered_map is O(1), but every element is a separately allocated node and every lookup follows a pointer
+// into a bucket list. FlatHashMap keeps all elements in one array and finds them through a parallel array of
+// one-byte control words:
+//
+// - The hash is split in two. The high bits (H1) pick the slot where probing starts, the low 7 bits (H2) are stored
+//   in the slot's control byte; an empty slot has the control byte 0x80.
+// - A lookup loads 16 control bytes at once and compares all of them with H2 in one SSE2 instruction (a portable
+//   SWAR version is used without SSE2). Only slots whose byte matches, about 1 in 128 of the others, have their key
+//   compared. A group with an empty byte ends the search.
+// - Probing is linear, slot by slot, so erase can shift the following elements of the cluster back instead of
+//   leaving a "deleted" marker (tombstone) that slows down later lookups (Knuth's Algorithm R).
+// - The table doubles when it is 3/4 full.
+// - With a transparent hash (the default for std::string keys), find/contains/erase accept a std::string_view or
+//   const char* without building a std::string.
+//
+// Iterators yield std::pair<const Key&, Value&>, so `for (const auto& [key, value] : map)` and it->second work as
+// usual. Like std::unordered_map, inserting may invalidate iterators; unlike it, so may erase.
+//
+// In C#, Dictionary<TKey, TValue> also keeps its entries in one array, but chains collisions through indices.
+
+// Default hash: std::hash, except std::string which also hashes string_views and C strings (heterogeneous lookup)
+template <typename Key>
+struct FlatHash : std::hash<Key> {};
+
+template <>
+struct FlatHash<std::string> {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+};
+
+namespace flat_detail {
+
+constexpr std::int8_t emptyControl = static_cast<std::int8_t>(0x80);
+constexpr std::size_t groupWidth = 16;
+
+// std::hash of an integer is the integer itself on common standard libraries. Multiplying by 2^64 / golden ratio
+// and folding the two halves of the 128-bit product gives every output bit a dependence on every input bit.
+inline std::size_t mix(std::size_t hash) {
+    constexpr std::uint64_t k = 0x9E3779B97F4A7C15ull;
+    const auto h = static_cast<std::uint64_t>(hash);
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(h) * k;
+    return static_cast<std::size_t>(static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t high;
+    const std::uint64_t low = _umul128(h, k, &high);
+    return static_cast<std::size_t>(low ^ high);
+#else
+    // The high half of the product from four 32 x 32-bit products
+    const std::uint64_t lowLow = (h & 0xFFFFFFFF) * (k & 0xFFFFFFFF);
+    const std::uint64_t highLow = (h >> 32) * (k & 0xFFFFFFFF);
+    const std::uint64_t lowHigh = (h & 0xFFFFFFFF) * (k >> 32);
+    const std::uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+    const std::uint64_t high = (h >> 32) * (k >> 32) + (highLow >> 32) + (cross >> 32);
+    return static_cast<std::size_t>((h * k) ^ high);
+#endif
+}
+
+// Bit i is set for every control byte i of the group that matches
+class BitMask {
+public:
+    explicit BitMask(std::uint32_t bits) : bits(bits) {}
+
+    explicit operator bool() const { return bits != 0; }
+    unsigned lowest() const { return static_cast<unsigned>(std::countr_zero(bits)); }
+    void removeLowest() { bits &= bits - 1; }
+
+private:
+    std::uint32_t bits;
+};
+
+// 16 control bytes, loaded from any position (unaligned)
+class Group {
+public:
+    explicit Group(const std::int8_t* control) {
+#if defined(FLAT_HASH_SSE2)
+        bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else
+        std::memcpy(words, control, groupWidth);
+#endif
+    }
+
+    BitMask match(std::int8_t h2) const {
+#if defined(FLAT_HASH_SSE2)
+        const __m128i equal = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2));
+        return BitMask(static_cast<std::uint32_t>(_mm_movemask_epi8(equal)));
+#else
+        // SWAR: a byte of x is zero where the control byte equals h2; the classic "has zero byte" trick finds them
+        // (it can report a false match just above a true one, which the key comparison filters out)
+        std::uint32_t result = 0;
+        for (int half = 0; half < 2; ++half) {
+            const std::uint64_t x = words[half] ^ (lsbs * static_cast<std::uint8_t>(h2));
+            result |= compress((x - lsbs) & ~x & msbs) << (8 * half);
+        }
+        return BitMask(result);
+#endif
+    }
+
+    // Only empty control bytes have the high bit set
+    BitMask matchEmpty() const {
+#if defined(FLAT_HASH_SSE2)
+        return BitMask(static_cast<std::uint32_t>(_mm_movemask_epi8(bytes)));
+#else
+        return BitMask(compress(words[0] & msbs) | (compress(words[1] & msbs) << 8));
+#endif
+    }
+
+private:
+#if defined(FLAT_HASH_SSE2)
+    __m128i bytes;
+#else
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+    // High bit of each of the 8 bytes -> 8 consecutive bits (little-endian byte order)
+    static std::uint32_t compress(std::uint64_t highBits) {
+        return static_cast<std::uint32_t>(((highBits >> 7) * 0x0102040810204080ull) >> 56);
+    }
+
+    std::uint64_t words[2];
+#endif
+};
+
+// Erase without tombstones in a linear-probing table (Knuth's Algorithm R): walks the cluster after the hole and moves
+// back every element whose probe sequence passes through it, so no lookup ever needs to step over a gap.
+// occupied(i) tells whether slot i holds an element, home(i) is its probe start (before masking), move(from, to)
+// moves it. Returns the slot that is left empty.
+template <typename Occupied, typename Home, typename Move>
+std::size_t backwardShift(std::size_t hole, std::size_t mask, Occupied occupied, Home home, Move move) {
+    for (std::size_t next = (hole + 1) & mask; occupied(next); next = (next + 1) & mask) {
+        const std::size_t start = home(next) & mask;
+        if (((next - start) & mask) >= ((next - hole) & mask)) {
+            move(next, hole);
+            hole = next;
+        }
+    }
+    return hole;
+}
+
+} // namespace flat_detail
+
+template <typename Key, typename Value, typename Hash = FlatHash<Key>, typename KeyEqual = std::equal_to<>>
+class FlatHashMap {
+    struct Slot {
+        Key key;
+        Value value;
+    };
+
+    // Heterogeneous lookup is only offered when both the hash and the equality accept other key types
+    static constexpr bool transparent = requires {
+        typename Hash::is_transparent;
+        typename KeyEqual::is_transparent;
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using reference = std::pair<const Key&, Value&>;
+    using const_reference = std::pair<const Key&, const Value&>;
+
+    template <bool Const>
+    class Iterator {
+        using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+
+    public:
+        using value_type = std::pair<const Key, Value>;
+        using reference = std::conditional_t<Const, FlatHashMap::const_reference, FlatHashMap::reference>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        // it->second needs a pointer; the pair of references lives in the proxy
+        struct pointer {
+            reference pair;
+            const reference* operator->() const { return &pair; }
+        };
+
+        Iterator() = default;
+        Iterator(Map* map, std::size_t index) : map(map), index(index) { skipEmpty(); }
+        operator Iterator<true>() const
+            requires(!Const)
+        {
+            return Iterator<true>(map, index);
+        }
+
+        reference operator*() const { return {map->slots[index].key, map->slots[index].value}; }
+        pointer operator->() const { return pointer{**this}; }
+
+        Iterator& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        friend class FlatHashMap;
+
+        void skipEmpty() {
+            while (index < map->capacityValue && map->control[index] == flat_detail::emptyControl) {
+                ++index;
+            }
+        }
+
+        Map* map = nullptr;
+        std::size_t index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    FlatHashMap(std::initializer_list<std::pair<Key, Value>> items) {
+        reserve(items.size());
+        for (const auto& [key, value] : items) {
+            insert_or_assign(key, value);
+        }
+    }
+
+    FlatHashMap(const FlatHashMap& other) : hasher(other.hasher), equal(other.equal) {
+        reserve(other.size());
+        for (const auto& [key, value] : other) {
+            try_emplace(key, value);
+        }
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept { swap(other); }
+
+    FlatHashMap& operator=(FlatHashMap other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatHashMap() { release(); }
+
+    void swap(FlatHashMap& other) noexcept {
+        std::swap(control, other.control);
+        std::swap(slots, other.slots);
+        std::swap(capacityValue, other.capacityValue);
+        std::swap(count, other.count);
+        std::swap(hasher, other.hasher);
+        std::swap(equal, other.equal);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacityValue); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacityValue); }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::size_t capacity() const { return capacityValue; }
+    double load_factor() const { return capacityValue ? static_cast<double>(count) / capacityValue : 0.0; }
+
+    // Make room for n elements without rehashing
+    void reserve(std::size_t n) {
+        std::size_t wanted = flat_detail::groupWidth;
+        while (wanted * 3 / 4 < n) {
+            wanted *= 2;
+        }
+        if (wanted > capacityValue) {
+            rehash(wanted);
+        }
+    }
+
+    void clear() {
+        destroyAll();
+        if (capacityValue) {
+            std::memset(control.get(), static_cast<std::uint8_t>(flat_detail::emptyControl),
+                        capacityValue + flat_detail::groupWidth);
+        }
+        count = 0;
+    }
+
+    // Inserts Value(args...) if key is absent; returns the element and whether it was inserted
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        const std::size_t hash = flat_detail::mix(hasher(key));
+        if (const std::size_t found = findIndex(key, hash); found != npos) {
+            return {iterator(this, found), false};
+        }
+        if (count + 1 > capacityValue * 3 / 4) {
+            rehash(capacityValue ? capacityValue * 2 : flat_detail::groupWidth);
+        }
+        const std::size_t index = firstEmpty(hash);
+        std::construct_at(&slots[index], Slot{Key(std::forward<K>(key)), Value(std::forward<Args>(args)...)});
+        setControl(index, h2(hash));
+        ++count;
+        return {iterator(this, index), true};
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+        auto result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        if (!result.second) {
+            slots[result.first.index].value = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    // try_emplace may rehash, so slots is only read after it
+    Value& operator[](const Key& key) {
+        const std::size_t index = try_emplace(key).first.index;
+        return slots[index].value;
+    }
+
+    Value& operator[](Key&& key) {
+        const std::size_t index = try_emplace(std::move(key)).first.index;
+        return slots[index].value;
+    }
+
+    // K is Key, or anything the transparent hash and equality accept (e.g. std::string_view for std::string)
+    template <typename K = Key>
+        requires(std::is_convertible_v<const K&, const Key&> || transparent)
+    iterator find(const K& key) {
+        const std::size_t index = findIndex(key, flat_detail::mix(hasher(key)));
+        return index == npos ? end() : iterator(this, index);
+    }
+
+    template <typename K = Key>
+        requires(std::is_convertible_v<const K&, const Key&> || transparent)
+    const_iterator find(const K& key) const {
+        const std::size_t index = findIndex(key, flat_detail::mix(hasher(key)));
+        return index == npos ? end() : const_iterator(this, index);
+    }
+
+    template <typename K = Key>
+        requires(std::is_convertible_v<const K&, const Key&> || transparent)
+    bool contains(const K& key) const {
+        return findIndex(key, flat_detail::mix(hasher(key))) != npos;
+    }
+
+    template <typename K = Key>
+        requires(std::is_convertible_v<const K&, const Key&> || transparent)
+    Value& at(const K& key) {
+        const std::size_t index = findIndex(key, flat_detail::mix(hasher(key)));
+        if (index == npos) {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return slots[index].value;
+    }
+
+    // Returns the number of elements removed (0 or 1)
+    template <typename K = Key>
+        requires(std::is_convertible_v<const K&, const Key&> || transparent)
+    std::size_t erase(const K& key) {
+        std::size_t hole = findIndex(key, flat_detail::mix(hasher(key)));
+        if (hole == npos) {
+            return 0;
+        }
+        hole = flat_detail::backwardShift(
+            hole, capacityValue - 1, [this](std::size_t i) { return control[i] != flat_detail::emptyControl; },
+            [this](std::size_t i) { return h1(flat_detail::mix(hasher(slots[i].key))); },
+            [this](std::size_t from, std::size_t to) {
+                slots[to] = std::move(slots[from]);
+                setControl(to, control[from]);
+            });
+        std::destroy_at(&slots[hole]);
+        setControl(hole, flat_detail::emptyControl);
+        --count;
+        return 1;
+    }
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    static std::size_t h1(std::size_t hash) { return hash >> 7; }
+    static std::int8_t h2(std::size_t hash) { return static_cast<std::int8_t>(hash & 0x7F); }
+
+    template <typename K>
+    std::size_t findIndex(const K& key, std::size_t hash) const {
+        if (capacityValue == 0) {
+            return npos;
+        }
+        const std::size_t mask = capacityValue - 1;
+        for (std::size_t position = h1(hash) & mask;; position = (position + flat_detail::groupWidth) & mask) {
+            const flat_detail::Group group(control.get() + position);
+            for (auto candidates = group.match(h2(hash)); candidates; candidates.removeLowest()) {
+                const std::size_t index = (position + candidates.lowest()) & mask;
+                if (equal(slots[index].key, key)) {
+                    return index;
+                }
+            }
+            if (group.matchEmpty()) {
+                return npos; // Every element lies between its home slot and the next empty slot
+            }
+        }
+    }
+
+    std::size_t firstEmpty(std::size_t hash) const {
+        const std::size_t mask = capacityValue - 1;
+        for (std::size_t position = h1(hash) & mask;; position = (position + flat_detail::groupWidth) & mask) {
+            if (auto empty = flat_detail::Group(control.get() + position).matchEmpty()) {
+                return (position + empty.lowest()) & mask;
+            }
+        }
+    }
+
+    // The first 16 control bytes are copied after the end, so a group loaded near the end wraps around
+    void setControl(std::size_t index, std::int8_t value) {
+        control[index] = value;
+        if (index < flat_detail::groupWidth) {
+            control[capacityValue + index] = value;
+        }
+    }
+
+    void rehash(std::size_t newCapacity) {
+        FlatHashMap bigger;
+        bigger.hasher = hasher;
+        bigger.equal = equal;
+        bigger.allocate(newCapacity);
+        for (std::size_t i = 0; i < capacityValue; ++i) {
+            if (control[i] != flat_detail::emptyControl) {
+                const std::size_t hash = flat_detail::mix(hasher(slots[i].key));
+                const std::size_t index = bigger.firstEmpty(hash);
+                std::construct_at(&bigger.slots[index], std::move(slots[i]));
+                bigger.setControl(index, h2(hash));
+                ++bigger.count;
+            }
+        }
+        swap(bigger);
+    }
+
+    void allocate(std::size_t newCapacity) {
+        control = std::make_unique<std::int8_t[]>(newCapacity + flat_detail::groupWidth);
+        std::memset(control.get(), static_cast<std::uint8_t>(flat_detail::emptyControl),
+                    newCapacity + flat_detail::groupWidth);
+        slots = std::allocator<Slot>{}.allocate(newCapacity);
+        capacityValue = newCapacity;
+    }
+
+    void destroyAll() {
+        for (std::size_t i = 0; i < capacityValue; ++i) {
+            if (control[i] != flat_detail::emptyControl) {
+                std::destroy_at(&slots[i]);
+            }
+        }
+    }
+
+    void release() {
+        if (capacityValue) {
+            destroyAll();
+            std::allocator<Slot>{}.deallocate(slots, capacityValue);
+        }
+    }
+
+    std::unique_ptr<std::int8_t[]> control;
+    Slot* slots = nullptr; // Raw storage: only slots with a non-empty control byte hold a constructed Slot
+    std::size_t capacityValue = 0;
+    std::size_t count = 0;
+    Hash hasher;
+    KeyEqual equal;
+};
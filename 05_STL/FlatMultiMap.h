@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Eytzinger.h"
+
+// Multimap stored as two sorted arrays, for indices that are built once and queried many times.
+//
+// NoobMultiMap (multimap_example_noob.cpp) appends pairs to a vector and can only find a key by scanning all of it.
+// std::multimap is a red-black tree with one heap node per element. FlatMultiMap keeps the keys and the values in two
+// vectors sorted by key, in insertion order among equal keys (like std::multimap):
+//
+// - Construction from unsorted pairs sorts once, in O(N log N). insert() and erase() shift the arrays and rebuild
+//   the index, O(N) each, so build the map in bulk and query it afterwards.
+// - Iteration walks arrays, and an element costs sizeof(Key) + sizeof(Value) plus the index, instead of a tree node
+//   with three pointers, a color and an allocation header.
+// - equal_range() searches an index of the distinct keys stored in Eytzinger order (the layout of a binary heap:
+//   the children of slot k are 2k and 2k + 1). The first levels of the search share a few cache lines, the loop
+//   has no unpredictable branch, and the slots a cache line's worth of levels down are prefetched while the current
+//   level is compared (the layout and search are shared with EytzingerSet, in Eytzinger.h).
+//   Each index slot also holds where that key's run of elements starts and ends, so one search finds the range.
+// - lower_bound() and upper_bound() take any key and run a branchless binary search over the sorted keys.
+//
+// Keys are compared with Compare only; keys that are equivalent under it are one run. Iterators yield
+// std::pair<const Key&, Value&>; insert() and erase() invalidate them. At most 2^32 - 1 elements.
+//
+// In C#, the nearest is ILookup<TKey, TElement> from ToLookup(), a hash table of groups; for ordered lookups one
+// sorts an array and uses Array.BinarySearch.
+
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMultiMap {
+    struct Run {
+        std::uint32_t first; // Index of the key's first element in keys/values
+        std::uint32_t last;  // One past its last element
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+    using reference = std::pair<const Key&, Value&>;
+    using const_reference = std::pair<const Key&, const Value&>;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using value_type = std::pair<const Key, Value>;
+        using reference = std::conditional_t<Const, FlatMultiMap::const_reference, FlatMultiMap::reference>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+        using Map = std::conditional_t<Const, const FlatMultiMap, FlatMultiMap>;
+
+        // it->second needs a pointer; the pair of references lives in the proxy
+        struct pointer {
+            reference pair;
+            const reference* operator->() const { return &pair; }
+        };
+
+        Iterator() = default;
+        Iterator(Map* map, std::size_t index) : map(map), index(index) {}
+        operator Iterator<true>() const
+            requires(!Const)
+        {
+            return Iterator<true>(map, index);
+        }
+
+        reference operator*() const { return {map->keys[index], map->values[index]}; }
+        pointer operator->() const { return pointer{**this}; }
+        reference operator[](difference_type offset) const { return *(*this + offset); }
+
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++index;
+            return old;
+        }
+        Iterator& operator--() {
+            --index;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator old = *this;
+            --index;
+            return old;
+        }
+        Iterator& operator+=(difference_type offset) {
+            index += static_cast<std::size_t>(offset);
+            return *this;
+        }
+        Iterator& operator-=(difference_type offset) {
+            index -= static_cast<std::size_t>(offset);
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type offset) { return it += offset; }
+        friend Iterator operator+(difference_type offset, Iterator it) { return it += offset; }
+        friend Iterator operator-(Iterator it, difference_type offset) { return it -= offset; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        auto operator<=>(const Iterator& other) const { return index <=> other.index; }
+
+    private:
+        friend class FlatMultiMap;
+
+        Map* map = nullptr;
+        std::size_t index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit FlatMultiMap(Compare less = Compare()) : less(std::move(less)) {}
+
+    // Build from pairs in any order. Equal keys keep their input order.
+    template <typename It>
+    FlatMultiMap(It first, It last, Compare less = Compare()) : less(std::move(less)) {
+        assign(first, last);
+    }
+
+    FlatMultiMap(std::initializer_list<std::pair<Key, Value>> pairs, Compare less = Compare())
+        : FlatMultiMap(pairs.begin(), pairs.end(), std::move(less)) {}
+
+    // Replace the contents with pairs in any order, sorting them once
+    template <typename It>
+    void assign(It first, It last) {
+        std::vector<std::pair<Key, Value>> pairs(first, last);
+        checkSize(pairs.size());
+        std::stable_sort(pairs.begin(), pairs.end(),
+                         [this](const auto& a, const auto& b) { return less(a.first, b.first); });
+        keys.clear();
+        values.clear();
+        keys.reserve(pairs.size());
+        values.reserve(pairs.size());
+        for (auto& [key, value] : pairs) {
+            keys.push_back(std::move(key));
+            values.push_back(std::move(value));
+        }
+        rebuildIndex();
+    }
+
+    bool empty() const { return keys.empty(); }
+    size_type size() const { return keys.size(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, keys.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, keys.size()); }
+
+    // Adds an element after any with an equal key. O(N): shifts both arrays and rebuilds the index.
+    iterator insert(const Key& key, Value value) {
+        checkSize(keys.size() + 1);
+        const std::size_t position = upperIndex(key);
+        keys.insert(keys.begin() + static_cast<std::ptrdiff_t>(position), key);
+        values.insert(values.begin() + static_cast<std::ptrdiff_t>(position), std::move(value));
+        rebuildIndex();
+        return iterator(this, position);
+    }
+
+    // Removes every element with this key; returns how many. O(N).
+    size_type erase(const Key& key) {
+        const auto [first, last] = runOf(key);
+        if (first == last) {
+            return 0;
+        }
+        const auto from = static_cast<std::ptrdiff_t>(first);
+        const auto to = static_cast<std::ptrdiff_t>(last);
+        keys.erase(keys.begin() + from, keys.begin() + to);
+        values.erase(values.begin() + from, values.begin() + to);
+        rebuildIndex();
+        return last - first;
+    }
+
+    void clear() {
+        keys.clear();
+        values.clear();
+        rebuildIndex();
+    }
+
+    // All elements with this key, through the Eytzinger index
+    std::pair<iterator, iterator> equal_range(const Key& key) {
+        const auto [first, last] = runOf(key);
+        return {iterator(this, first), iterator(this, last)};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        const auto [first, last] = runOf(key);
+        return {const_iterator(this, first), const_iterator(this, last)};
+    }
+
+    size_type count(const Key& key) const {
+        const auto [first, last] = runOf(key);
+        return last - first;
+    }
+
+    bool contains(const Key& key) const { return count(key) != 0; }
+
+    // First element with this key, or end()
+    iterator find(const Key& key) {
+        const auto [first, last] = runOf(key);
+        return first == last ? end() : iterator(this, first);
+    }
+
+    const_iterator find(const Key& key) const {
+        const auto [first, last] = runOf(key);
+        return first == last ? end() : const_iterator(this, first);
+    }
+
+    // First element whose key is not less than key, by a branchless binary search over the sorted keys
+    iterator lower_bound(const Key& key) { return iterator(this, lowerIndex(key)); }
+    const_iterator lower_bound(const Key& key) const { return const_iterator(this, lowerIndex(key)); }
+
+    // First element whose key is greater than key
+    iterator upper_bound(const Key& key) { return iterator(this, upperIndex(key)); }
+    const_iterator upper_bound(const Key& key) const { return const_iterator(this, upperIndex(key)); }
+
+    // Number of distinct keys
+    size_type keyCount() const { return indexKeys.size() - 1; }
+
+    // Bytes of the arrays themselves (not what a key or value owns on the heap, such as string characters)
+    size_type memoryBytes() const {
+        return keys.capacity() * sizeof(Key) + values.capacity() * sizeof(Value) +
+               indexKeys.capacity() * sizeof(Key) + runs.capacity() * sizeof(Run);
+    }
+
+private:
+    std::vector<Key> keys;
+    std::vector<Value> values;
+    // Distinct keys in Eytzinger order and their runs; slot 0 is unused, so the root is slot 1
+    std::vector<Key, eytzinger::CacheLineAllocator<Key>> indexKeys = {Key()};
+    std::vector<Run> runs = std::vector<Run>(1);
+    Compare less;
+
+    static void checkSize(std::size_t size) {
+        if (size > UINT32_MAX) {
+            throw std::length_error("FlatMultiMap holds at most 2^32 - 1 elements");
+        }
+    }
+
+    void rebuildIndex() {
+        std::vector<Run> sortedRuns;
+        for (std::size_t i = 0; i < keys.size();) {
+            std::size_t end = i + 1;
+            while (end < keys.size() && !less(keys[i], keys[end])) {
+                ++end;
+            }
+            sortedRuns.push_back({static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(end)});
+            i = end;
+        }
+        indexKeys.clear();
+        indexKeys.resize(sortedRuns.size() + 1);
+        runs.resize(sortedRuns.size() + 1);
+        eytzinger::layout(sortedRuns.size(), [&](std::size_t slot, std::size_t rank) {
+            runs[slot] = sortedRuns[rank];
+            indexKeys[slot] = keys[sortedRuns[rank].first];
+        });
+    }
+
+    // Slot of the smallest distinct key not less than key, or 0 if every key is less
+    std::size_t indexSlot(const Key& key) const {
+        return eytzinger::search(indexKeys.data(), indexKeys.size() - 1,
+                                 [&](const Key& slot) { return less(slot, key); });
+    }
+
+    std::pair<std::size_t, std::size_t> runOf(const Key& key) const {
+        const std::size_t slot = indexSlot(key);
+        if (slot == 0) {
+            return {keys.size(), keys.size()};
+        }
+        if (less(key, indexKeys[slot])) {
+            return {runs[slot].first, runs[slot].first}; // Absent: empty range where it would go
+        }
+        return {runs[slot].first, runs[slot].last};
+    }
+
+    std::size_t lowerIndex(const Key& key) const {
+        const Key* base = keys.data();
+        std::size_t n = keys.size();
+        if (n == 0) {
+            return 0;
+        }
+        while (n > 1) {
+            const std::size_t half = n / 2;
+            base = less(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<std::size_t>(base - keys.data()) + less(*base, key);
+    }
+
+    std::size_t upperIndex(const Key& key) const {
+        const Key* base = keys.data();
+        std::size_t n = keys.size();
+        if (n == 0) {
+            return 0;
+        }
+        while (n > 1) {
+            const std::size_t half = n / 2;
+            base = !less(key, base[half]) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<std::size_t>(base - keys.data()) + !less(key, *base);
+    }
+};
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Intrusive linked lists: the links live inside the elements instead of in separately allocated nodes.
+//
+// NoobList and std::list allocate a node per element that holds the value and the links, so every push is an
+// allocation and every step of a traversal is a pointer into that node, from which the value is another load away
+// if it is itself a pointer. An intrusive list allocates nothing: an element derives from a hook (the prev/next
+// pointers) and the list only links elements that already exist, wherever they live (a vector, a pool, the stack).
+//
+// - Pushing, inserting and unlinking are O(1) and cannot fail. Given a reference to an element, erase() or
+//   remove() unlinks it in O(1) without searching, because the element knows its neighbours.
+// - The list does not own the elements. Destroying or clearing the list only unlinks them; an element must be
+//   unlinked before it is destroyed.
+// - An element can be in several lists at once by deriving from several hooks with different tags, e.g. an LRU
+//   list and a per-bucket list.
+// - IntrusiveList is doubly linked and circular around a sentinel hook inside the list object, so there are no
+//   null checks at the ends. IntrusiveForwardList is singly linked: one pointer per element, push/pop at the front.
+//
+// This is how the Linux kernel (list_head), Boost.Intrusive and most allocators and schedulers keep their lists.
+//
+// In C#, LinkedList<T> allocates a LinkedListNode<T> per element; there is no standard intrusive list.
+
+struct DefaultListTag;
+
+template <typename Tag = DefaultListTag>
+class IntrusiveListHook {
+public:
+    IntrusiveListHook() = default;
+    // Copying an element does not copy its membership in a list
+    IntrusiveListHook(const IntrusiveListHook&) noexcept {}
+    IntrusiveListHook& operator=(const IntrusiveListHook&) noexcept { return *this; }
+
+    bool isLinked() const { return next != nullptr; }
+
+private:
+    template <typename, typename>
+    friend class IntrusiveList;
+
+    IntrusiveListHook* prev = nullptr;
+    IntrusiveListHook* next = nullptr;
+};
+
+template <typename T, typename Tag = DefaultListTag>
+class IntrusiveList {
+    using Hook = IntrusiveListHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from IntrusiveListHook<Tag>");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        Iterator() = default;
+        explicit Iterator(Hook* hook) : hook(hook) {}
+        operator Iterator<true>() const { return Iterator<true>(hook); }
+
+        reference operator*() const { return static_cast<reference>(*hook); }
+        pointer operator->() const { return &**this; }
+
+        Iterator& operator++() {
+            hook = hook->next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            hook = hook->next;
+            return old;
+        }
+        Iterator& operator--() {
+            hook = hook->prev;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator old = *this;
+            hook = hook->prev;
+            return old;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.hook == b.hook; }
+
+    private:
+        friend class IntrusiveList;
+        Hook* hook = nullptr;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    IntrusiveList() { sentinel.prev = sentinel.next = &sentinel; }
+
+    // The sentinel's address is part of the links, so a list cannot be copied or moved
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() { clear(); }
+
+    bool empty() const { return sentinel.next == &sentinel; }
+    size_type size() const { return count; }
+
+    T& front() { return static_cast<T&>(*sentinel.next); }
+    const T& front() const { return static_cast<const T&>(*sentinel.next); }
+    T& back() { return static_cast<T&>(*sentinel.prev); }
+    const T& back() const { return static_cast<const T&>(*sentinel.prev); }
+
+    iterator begin() { return iterator(sentinel.next); }
+    iterator end() { return iterator(&sentinel); }
+    const_iterator begin() const { return const_iterator(sentinel.next); }
+    const_iterator end() const { return const_iterator(const_cast<Hook*>(&sentinel)); }
+
+    // Iterator to an element that is in this list
+    iterator iteratorTo(T& element) { return iterator(&hookOf(element)); }
+
+    void push_front(T& element) { linkBefore(sentinel.next, hookOf(element)); }
+    void push_back(T& element) { linkBefore(&sentinel, hookOf(element)); }
+    void pop_front() { unlink(*sentinel.next); }
+    void pop_back() { unlink(*sentinel.prev); }
+
+    // Links element in front of position; returns an iterator to it
+    iterator insert(const_iterator position, T& element) {
+        linkBefore(position.hook, hookOf(element));
+        return iterator(&hookOf(element));
+    }
+
+    // Unlinks the element at position; returns the one after it
+    iterator erase(const_iterator position) {
+        Hook* next = position.hook->next;
+        unlink(*position.hook);
+        return iterator(next);
+    }
+
+    // Unlinks an element of this list, found through its own links
+    void remove(T& element) { unlink(hookOf(element)); }
+
+    // Unlinks every element for which predicate returns true
+    template <typename Predicate>
+    size_type remove_if(Predicate predicate) {
+        size_type removed = 0;
+        for (auto it = begin(); it != end();) {
+            if (predicate(*it)) {
+                it = erase(it);
+                ++removed;
+            } else {
+                ++it;
+            }
+        }
+        return removed;
+    }
+
+    // Moves all elements of other in front of position, in O(1)
+    void splice(const_iterator position, IntrusiveList& other) {
+        if (other.empty()) {
+            return;
+        }
+        Hook* first = other.sentinel.next;
+        Hook* last = other.sentinel.prev;
+        other.sentinel.prev = other.sentinel.next = &other.sentinel;
+        Hook* after = position.hook;
+        Hook* before = after->prev;
+        before->next = first;
+        first->prev = before;
+        last->next = after;
+        after->prev = last;
+        count += other.count;
+        other.count = 0;
+    }
+
+    void clear() {
+        Hook* hook = sentinel.next;
+        while (hook != &sentinel) {
+            Hook* next = hook->next;
+            hook->prev = hook->next = nullptr;
+            hook = next;
+        }
+        sentinel.prev = sentinel.next = &sentinel;
+        count = 0;
+    }
+
+private:
+    Hook sentinel;
+    size_type count = 0;
+
+    static Hook& hookOf(T& element) { return static_cast<Hook&>(element); }
+
+    void linkBefore(Hook* position, Hook& hook) {
+        hook.prev = position->prev;
+        hook.next = position;
+        position->prev->next = &hook;
+        position->prev = &hook;
+        ++count;
+    }
+
+    void unlink(Hook& hook) {
+        hook.prev->next = hook.next;
+        hook.next->prev = hook.prev;
+        hook.prev = hook.next = nullptr;
+        --count;
+    }
+};
+
+template <typename Tag = DefaultListTag>
+class IntrusiveForwardListHook {
+public:
+    IntrusiveForwardListHook() = default;
+    IntrusiveForwardListHook(const IntrusiveForwardListHook&) noexcept {}
+    IntrusiveForwardListHook& operator=(const IntrusiveForwardListHook&) noexcept { return *this; }
+
+private:
+    template <typename, typename>
+    friend class IntrusiveForwardList;
+
+    IntrusiveForwardListHook* next = nullptr;
+};
+
+template <typename T, typename Tag = DefaultListTag>
+class IntrusiveForwardList {
+    using Hook = IntrusiveForwardListHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from IntrusiveForwardListHook<Tag>");
+
+public:
+    using value_type = T;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        Iterator() = default;
+        explicit Iterator(Hook* hook) : hook(hook) {}
+        operator Iterator<true>() const { return Iterator<true>(hook); }
+
+        reference operator*() const { return static_cast<reference>(*hook); }
+        pointer operator->() const { return &**this; }
+
+        Iterator& operator++() {
+            hook = hook->next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            hook = hook->next;
+            return old;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.hook == b.hook; }
+
+    private:
+        friend class IntrusiveForwardList;
+        Hook* hook = nullptr;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    IntrusiveForwardList() = default;
+    IntrusiveForwardList(const IntrusiveForwardList&) = delete;
+    IntrusiveForwardList& operator=(const IntrusiveForwardList&) = delete;
+
+    // Unlike IntrusiveList, the links do not point back into the list object, so it can be moved
+    IntrusiveForwardList(IntrusiveForwardList&& other) noexcept { head.next = std::exchange(other.head.next, nullptr); }
+
+    bool empty() const { return head.next == nullptr; }
+
+    T& front() { return static_cast<T&>(*head.next); }
+    const T& front() const { return static_cast<const T&>(*head.next); }
+
+    iterator before_begin() { return iterator(&head); }
+    iterator begin() { return iterator(head.next); }
+    iterator end() { return iterator(nullptr); }
+    const_iterator begin() const { return const_iterator(head.next); }
+    const_iterator end() const { return const_iterator(nullptr); }
+
+    void push_front(T& element) { insert_after(before_begin(), element); }
+    void pop_front() { erase_after(before_begin()); }
+
+    iterator insert_after(const_iterator position, T& element) {
+        Hook& hook = element;
+        hook.next = position.hook->next;
+        position.hook->next = &hook;
+        return iterator(&hook);
+    }
+
+    // Unlinks the element after position; returns the one after that
+    iterator erase_after(const_iterator position) {
+        Hook* removed = position.hook->next;
+        position.hook->next = removed->next;
+        removed->next = nullptr;
+        return iterator(position.hook->next);
+    }
+
+    void reverse() {
+        Hook* previous = nullptr;
+        Hook* current = head.next;
+        while (current) {
+            Hook* next = current->next;
+            current->next = previous;
+            previous = current;
+            current = next;
+        }
+        head.next = previous;
+    }
+
+    void clear() { head.next = nullptr; }
+
+private:
+    Hook head; // Only head.next is used: before_begin() points here
+};
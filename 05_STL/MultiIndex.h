@@ -0,0 +1,616 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "FlatHashMap.h" // FlatHash, flat_detail::mix and backwardShift
+
+// Container that stores each element once and keeps several ordered and hashed indices over it, like
+// Boost.MultiIndex.
+//
+// set_example_complex.cpp keeps one std::set<Person, ...> per order (by ID, by name and age, by age), so every
+// Person is copied into three trees, and updating or removing a person means finding and changing it in all three.
+// MultiIndex keeps the elements in one vector (the arena) and the indices hold only 32-bit handles, positions in
+// that vector:
+//
+// - An element is reached through a handle, which stays valid until the element is erased. Erased slots go on a
+//   free list and are reused by later inserts, so the arena stays dense.
+// - Each index is declared with a key extractor (KeyFrom<&Person::getId>, or any functor that returns the key of an
+//   element): OrderedUnique and OrderedNonUnique are red-black trees of handles compared through the arena,
+//   HashedUnique is an open-addressing table of handles with linear probing and backward-shift erase, which also
+//   stores 32 bits of each key's hash so most mismatches are rejected without reading the element.
+// - index<I>() returns the I-th index, with the lookups of std::set or std::unordered_set (find, count, contains,
+//   and lower_bound, upper_bound and equal_range for ordered indices), taking any key the comparator or hash
+//   accepts. Its iterators yield const T& and tell the element's handle().
+// - insert() adds the element to every index, or to none if a unique index already has its key. erase(handle)
+//   removes it from all of them. modify(handle, f) applies f to a copy of the element and re-indexes it only in the
+//   indices whose key changed; if a unique index would then hold a key twice, the element is left as it was.
+// - Equal keys in a non-unique ordered index are ordered by handle, so erasing or re-indexing one of many equal
+//   keys is O(log N), not a scan of the run.
+//
+// Elements are only changed through modify(), so the indices always agree with them. The indices refer to the
+// container's own arena, so a MultiIndex can be neither copied nor moved (hold it by unique_ptr to move it).
+//
+// In C#, there is no equivalent in the base library; the usual pattern is a List<T> plus one Dictionary or
+// SortedSet of indices per lookup, kept in sync by hand.
+
+// Position of an element in a MultiIndex
+using MultiIndexHandle = std::uint32_t;
+
+// Key extractor that calls a getter or reads a data member: KeyFrom<&Person::getAge>
+template <auto Member>
+struct KeyFrom {
+    template <typename T>
+    decltype(auto) operator()(const T& element) const {
+        return std::invoke(Member, element);
+    }
+};
+
+namespace multi_index_detail {
+
+template <typename T>
+using Arena = std::vector<std::optional<T>>;
+
+template <typename T, typename KeyFn>
+using KeyType = std::remove_cvref_t<std::invoke_result_t<const KeyFn&, const T&>>;
+
+// A lookup key, told apart from a handle by the index comparators even when the key is an integer too
+template <typename K>
+struct Probe {
+    const K& key;
+};
+
+template <typename T, typename KeyFn, typename Compare, bool Unique>
+class OrderedIndex {
+    struct Less {
+        using is_transparent = void;
+
+        const Arena<T>* arena;
+        KeyFn key;
+        Compare less;
+
+        decltype(auto) keyOf(MultiIndexHandle handle) const { return key(*(*arena)[handle]); }
+
+        bool operator()(MultiIndexHandle a, MultiIndexHandle b) const {
+            decltype(auto) keyA = keyOf(a);
+            decltype(auto) keyB = keyOf(b);
+            if constexpr (Unique) {
+                return less(keyA, keyB);
+            } else {
+                return less(keyA, keyB) || (!less(keyB, keyA) && a < b);
+            }
+        }
+
+        template <typename K>
+        bool operator()(MultiIndexHandle a, const Probe<K>& b) const {
+            return less(keyOf(a), b.key);
+        }
+
+        template <typename K>
+        bool operator()(const Probe<K>& a, MultiIndexHandle b) const {
+            return less(a.key, keyOf(b));
+        }
+    };
+
+    using Entries = std::set<MultiIndexHandle, Less>;
+
+public:
+    class const_iterator {
+    public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() = default;
+        const_iterator(typename Entries::const_iterator it, const Arena<T>* arena) : it(it), arena(arena) {}
+
+        reference operator*() const { return *(*arena)[*it]; }
+        pointer operator->() const { return &**this; }
+        MultiIndexHandle handle() const { return *it; }
+
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++it;
+            return old;
+        }
+        const_iterator& operator--() {
+            --it;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --it;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+
+    private:
+        typename Entries::const_iterator it;
+        const Arena<T>* arena = nullptr;
+    };
+
+    using iterator = const_iterator;
+
+    explicit OrderedIndex(const Arena<T>* arena) : entries(Less{arena, KeyFn(), Compare()}), arena(arena) {}
+
+    const_iterator begin() const { return const_iterator(entries.begin(), arena); }
+    const_iterator end() const { return const_iterator(entries.end(), arena); }
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    // First element whose key is not less than key
+    template <typename K>
+    const_iterator lower_bound(const K& key) const {
+        return const_iterator(entries.lower_bound(Probe<K>{key}), arena);
+    }
+
+    // First element whose key is greater than key
+    template <typename K>
+    const_iterator upper_bound(const K& key) const {
+        return const_iterator(entries.upper_bound(Probe<K>{key}), arena);
+    }
+
+    template <typename K>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        const auto [first, last] = entries.equal_range(Probe<K>{key});
+        return {const_iterator(first, arena), const_iterator(last, arena)};
+    }
+
+    // The first element with this key, or end()
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const auto it = entries.lower_bound(Probe<K>{key});
+        const Less& less = entries.key_comp();
+        return it != entries.end() && !less(Probe<K>{key}, *it) ? const_iterator(it, arena) : end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    std::size_t count(const K& key) const {
+        const auto [first, last] = entries.equal_range(Probe<K>{key});
+        return static_cast<std::size_t>(std::distance(first, last));
+    }
+
+    // Used by MultiIndex; the element at handle must hold the key it is indexed under
+    void insert(MultiIndexHandle handle) { entries.insert(handle); }
+    void erase(MultiIndexHandle handle) { entries.erase(handle); }
+    void clear() { entries.clear(); }
+
+    // Another element that already has the key of value, if this index is unique
+    std::optional<MultiIndexHandle> conflict(const T& value, MultiIndexHandle self) const {
+        if constexpr (Unique) {
+            const auto it = find(entries.key_comp().key(value));
+            if (it != end() && it.handle() != self) {
+                return it.handle();
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool sameKey(const T& a, const T& b) const {
+        const Less& less = entries.key_comp();
+        decltype(auto) keyA = less.key(a);
+        decltype(auto) keyB = less.key(b);
+        return !less.less(keyA, keyB) && !less.less(keyB, keyA);
+    }
+
+private:
+    Entries entries;
+    const Arena<T>* arena;
+};
+
+template <typename T, typename KeyFn, typename Hash, typename Equal>
+class HashedIndex {
+    struct Slot {
+        MultiIndexHandle handle;
+        std::uint32_t hash; // High bits of the mixed hash; the home slot is hash & mask
+    };
+
+    static constexpr MultiIndexHandle emptySlot = static_cast<MultiIndexHandle>(-1);
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+    class const_iterator {
+    public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+        const_iterator(const HashedIndex* index, std::size_t position) : index(index), position(position) {
+            skipEmpty();
+        }
+
+        reference operator*() const { return index->element(handle()); }
+        pointer operator->() const { return &**this; }
+        MultiIndexHandle handle() const { return index->slots[position].handle; }
+
+        const_iterator& operator++() {
+            ++position;
+            skipEmpty();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+
+    private:
+        void skipEmpty() {
+            while (position < index->slots.size() && index->slots[position].handle == emptySlot) {
+                ++position;
+            }
+        }
+
+        const HashedIndex* index = nullptr;
+        std::size_t position = 0;
+    };
+
+    using iterator = const_iterator;
+
+    explicit HashedIndex(const Arena<T>* arena) : arena(arena) {}
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+    std::size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const std::size_t position = findSlot(key, hashOf(key));
+        return position == npos ? end() : const_iterator(this, position);
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    std::size_t count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // Make room for n elements without rehashing
+    void reserve(std::size_t n) {
+        std::size_t wanted = 16;
+        while (wanted * 3 / 4 < n) {
+            wanted *= 2;
+        }
+        if (wanted > slots.size()) {
+            rehash(wanted);
+        }
+    }
+
+    // Used by MultiIndex; the key of the element at handle must not be in the index yet
+    void insert(MultiIndexHandle handle) {
+        reserve(used + 1);
+        place({handle, hashOf(key(element(handle)))});
+        ++used;
+    }
+
+    void erase(MultiIndexHandle handle) {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t hole = hashOf(key(element(handle))) & mask;
+        while (slots[hole].handle != handle) {
+            hole = (hole + 1) & mask;
+        }
+        hole = flat_detail::backwardShift(
+            hole, mask, [this](std::size_t i) { return slots[i].handle != emptySlot; },
+            [this](std::size_t i) { return slots[i].hash; },
+            [this](std::size_t from, std::size_t to) { slots[to] = slots[from]; });
+        slots[hole].handle = emptySlot;
+        --used;
+    }
+
+    void clear() {
+        for (Slot& slot : slots) {
+            slot.handle = emptySlot;
+        }
+        used = 0;
+    }
+
+    std::optional<MultiIndexHandle> conflict(const T& value, MultiIndexHandle self) const {
+        decltype(auto) valueKey = key(value);
+        const std::size_t position = findSlot(valueKey, hashOf(valueKey));
+        if (position != npos && slots[position].handle != self) {
+            return slots[position].handle;
+        }
+        return std::nullopt;
+    }
+
+    bool sameKey(const T& a, const T& b) const { return equal(key(a), key(b)); }
+
+private:
+    const T& element(MultiIndexHandle handle) const { return *(*arena)[handle]; }
+
+    // 32 bits of FlatHashMap's mixed hash
+    template <typename K>
+    std::uint32_t hashOf(const K& k) const {
+        const std::uint64_t mixed = flat_detail::mix(hasher(k));
+        return static_cast<std::uint32_t>(mixed ^ (mixed >> 32));
+    }
+
+    template <typename K>
+    std::size_t findSlot(const K& k, std::uint32_t hash) const {
+        if (slots.empty()) {
+            return npos;
+        }
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t position = hash & mask; slots[position].handle != emptySlot;
+             position = (position + 1) & mask) {
+            if (slots[position].hash == hash && equal(key(element(slots[position].handle)), k)) {
+                return position;
+            }
+        }
+        return npos;
+    }
+
+    void place(Slot slot) {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t position = slot.hash & mask;
+        while (slots[position].handle != emptySlot) {
+            position = (position + 1) & mask;
+        }
+        slots[position] = slot;
+    }
+
+    // Only the stored hashes are needed, so growing does not read the elements
+    void rehash(std::size_t newCapacity) {
+        std::vector<Slot> old(newCapacity, Slot{emptySlot, 0});
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.handle != emptySlot) {
+                place(slot);
+            }
+        }
+    }
+
+    std::vector<Slot> slots; // Power-of-two size
+    std::size_t used = 0;
+    const Arena<T>* arena;
+    KeyFn key;
+    Hash hasher;
+    Equal equal;
+};
+
+} // namespace multi_index_detail
+
+// Index declarations for MultiIndex<T, ...>. Compare and Equal may be transparent (the defaults are), so lookups
+// accept any key type they can compare; the default Hash is FlatHash, which lets std::string keys be looked up by
+// string_view or C string.
+template <typename KeyFn, typename Compare = std::less<>>
+struct OrderedUnique {
+    template <typename T>
+    using Index = multi_index_detail::OrderedIndex<T, KeyFn, Compare, true>;
+};
+
+template <typename KeyFn, typename Compare = std::less<>>
+struct OrderedNonUnique {
+    template <typename T>
+    using Index = multi_index_detail::OrderedIndex<T, KeyFn, Compare, false>;
+};
+
+template <typename KeyFn, typename Hash = void, typename Equal = std::equal_to<>>
+struct HashedUnique {
+    template <typename T>
+    using Index = multi_index_detail::HashedIndex<
+        T, KeyFn, std::conditional_t<std::is_void_v<Hash>, FlatHash<multi_index_detail::KeyType<T, KeyFn>>, Hash>,
+        Equal>;
+};
+
+template <typename T, typename... Specs>
+class MultiIndex {
+    using Arena = multi_index_detail::Arena<T>;
+    using Indices = std::tuple<typename Specs::template Index<T>...>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // All elements, in arena order
+    class const_iterator {
+    public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+        const_iterator(const Arena* arena, std::size_t position) : arena(arena), position(position) { skipErased(); }
+
+        reference operator*() const { return *(*arena)[position]; }
+        pointer operator->() const { return &**this; }
+        MultiIndexHandle handle() const { return static_cast<MultiIndexHandle>(position); }
+
+        const_iterator& operator++() {
+            ++position;
+            skipErased();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+
+    private:
+        void skipErased() {
+            while (position < arena->size() && !(*arena)[position]) {
+                ++position;
+            }
+        }
+
+        const Arena* arena = nullptr;
+        std::size_t position = 0;
+    };
+
+    using iterator = const_iterator;
+
+    MultiIndex() : indices(arenaFor<Specs>()...) {}
+    MultiIndex(const MultiIndex&) = delete;
+    MultiIndex& operator=(const MultiIndex&) = delete;
+
+    template <std::size_t I>
+    const auto& index() const {
+        return std::get<I>(indices);
+    }
+
+    const_iterator begin() const { return const_iterator(&arena, 0); }
+    const_iterator end() const { return const_iterator(&arena, arena.size()); }
+    size_type size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Make room for n elements in the arena and the hashed indices (the trees allocate a node per element anyway)
+    void reserve(size_type n) {
+        arena.reserve(n);
+        std::apply(
+            [n](auto&... index) {
+                (
+                    [&] {
+                        if constexpr (requires { index.reserve(n); }) {
+                            index.reserve(n);
+                        }
+                    }(),
+                    ...);
+            },
+            indices);
+    }
+
+    bool contains(MultiIndexHandle handle) const { return handle < arena.size() && arena[handle]; }
+
+    const T& operator[](MultiIndexHandle handle) const { return *arena[handle]; }
+
+    const T& at(MultiIndexHandle handle) const {
+        check(handle, "MultiIndex::at");
+        return *arena[handle];
+    }
+
+    // Adds value to every index. If a unique index already has its key, nothing changes and the handle returned is
+    // that of the element that has it.
+    std::pair<MultiIndexHandle, bool> insert(T value) {
+        if (const auto other = conflict(value, emptyHandle)) {
+            return {*other, false};
+        }
+        MultiIndexHandle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+            arena[handle].emplace(std::move(value));
+        } else {
+            handle = static_cast<MultiIndexHandle>(arena.size());
+            arena.emplace_back(std::move(value));
+        }
+        std::apply([handle](auto&... index) { (index.insert(handle), ...); }, indices);
+        ++count;
+        return {handle, true};
+    }
+
+    template <typename... Args>
+    std::pair<MultiIndexHandle, bool> emplace(Args&&... args) {
+        return insert(T(std::forward<Args>(args)...));
+    }
+
+    void erase(MultiIndexHandle handle) {
+        check(handle, "MultiIndex::erase");
+        std::apply([handle](auto&... index) { (index.erase(handle), ...); }, indices);
+        arena[handle].reset();
+        freeHandles.push_back(handle);
+        --count;
+    }
+
+    // Calls f(T&) on a copy of the element and stores the result, re-indexing it in the indices whose key changed.
+    // Returns false, and leaves the element unchanged, if the result has the key of another element in a unique
+    // index.
+    template <typename F>
+    bool modify(MultiIndexHandle handle, F&& f) {
+        check(handle, "MultiIndex::modify");
+        T updated = *arena[handle];
+        std::forward<F>(f)(updated);
+        if (conflict(updated, handle)) {
+            return false;
+        }
+        std::array<bool, sizeof...(Specs)> changed{};
+        forEachIndex([&](auto& index, std::size_t i) {
+            changed[i] = !index.sameKey(*arena[handle], updated);
+            if (changed[i]) {
+                index.erase(handle);
+            }
+        });
+        arena[handle].emplace(std::move(updated));
+        forEachIndex([&](auto& index, std::size_t i) {
+            if (changed[i]) {
+                index.insert(handle);
+            }
+        });
+        return true;
+    }
+
+    void clear() {
+        std::apply([](auto&... index) { (index.clear(), ...); }, indices);
+        arena.clear();
+        freeHandles.clear();
+        count = 0;
+    }
+
+private:
+    static constexpr MultiIndexHandle emptyHandle = static_cast<MultiIndexHandle>(-1);
+
+    // One arena pointer per index, for the constructor of indices
+    template <typename>
+    const Arena* arenaFor() const {
+        return &arena;
+    }
+
+    template <typename F>
+    void forEachIndex(F&& f) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (f(std::get<I>(indices), I), ...);
+        }(std::index_sequence_for<Specs...>());
+    }
+
+    std::optional<MultiIndexHandle> conflict(const T& value, MultiIndexHandle self) const {
+        std::optional<MultiIndexHandle> other;
+        std::apply([&](const auto&... index) { ((other = index.conflict(value, self)) || ...); }, indices);
+        return other;
+    }
+
+    void check(MultiIndexHandle handle, const char* operation) const {
+        if (!contains(handle)) {
+            throw std::out_of_range(std::string(operation) + ": no element with this handle");
+        }
+    }
+
+    Arena arena;
+    std::vector<MultiIndexHandle> freeHandles;
+    std::size_t count = 0;
+    Indices indices;
+};
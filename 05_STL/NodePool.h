@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Node-pool allocator for linked structures: lists, trees, graphs, anything that allocates one node at a time.
+//
+// NoobList, NoobForwardList (list_example_noob.cpp, forward_list_example_noob.cpp) and std::list call the general
+// purpose allocator once per node. Each call costs tens of nanoseconds, adds a header to every node, and after some
+// inserts and erases the nodes of one list end up scattered across the heap. A node pool serves all nodes of one
+// type from large slabs instead:
+//
+// - Every type T gets its own pool, so its nodes sit next to each other. A slab holds about 64 KB of nodes and is
+//   carved from front to back, so nodes allocated one after another are adjacent in memory.
+// - A freed node goes on a free list (stored inside the freed node itself) and is handed out again by the next
+//   allocation, most recently freed first, while it is still in the cache. Slabs are never returned; the pools
+//   live until the process exits, so containers with static lifetime can still free their nodes at exit.
+// - With ThreadCache (the default) every thread keeps a small private stack of free nodes and takes or returns them
+//   from the shared, mutex-protected pool in batches of 32, so most allocations take no lock. A node may be freed by
+//   a different thread than the one that allocated it. Once a thread's cache is destroyed at thread exit (for the
+//   main thread, before static objects are), that thread allocates and frees through the shared pool under its lock,
+//   so a static container can still free its nodes. Without ThreadCache there is no lock at all, and the pool must
+//   only be used from one thread.
+//
+// PoolAllocator<T> plugs the pool into standard containers (std::list<int, PoolAllocator<int>>); the container
+// rebinds it to its node type. PoolAllocated<Node> gives a hand-written node class an operator new/delete that use
+// the pool, so `new Node(value)` in code like NoobList is pooled without other changes.
+//
+// In C#, the garbage collector already allocates by bumping a pointer, so nodes allocated together are adjacent;
+// pooling there is about avoiding collections (ObjectPool<T>), not about allocation speed.
+
+// Totals over all node pools, for the statistics in the examples
+struct NodePoolStats {
+    std::size_t slabs = 0;     // Slabs requested from the system allocator
+    std::size_t slabBytes = 0; // Their total size
+};
+
+namespace pool_detail {
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+inline std::atomic<std::size_t> slabCount{0};
+inline std::atomic<std::size_t> slabByteCount{0};
+
+constexpr std::size_t slabBytes = 64 * 1024;
+constexpr std::size_t batchSize = 32;
+
+// Blocks of one size and alignment, carved from slabs. Not thread safe.
+class FixedPool {
+public:
+    // Every block must also be able to hold a FreeBlock, so blocks are at least pointer-sized and -aligned
+    FixedPool(std::size_t size, std::size_t align)
+        : blockAlign(std::max(align, alignof(FreeBlock))),
+          blockSize((std::max(size, sizeof(FreeBlock)) + blockAlign - 1) / blockAlign * blockAlign),
+          blocksPerSlab(std::max<std::size_t>(16, slabBytes / blockSize)) {}
+
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    void* allocate() {
+        if (freeList) {
+            return std::exchange(freeList, freeList->next);
+        }
+        if (carve == carveEnd) {
+            addSlab();
+        }
+        return std::exchange(carve, carve + blockSize);
+    }
+
+    void deallocate(void* pointer) { freeList = ::new (pointer) FreeBlock{freeList}; }
+
+private:
+    const std::size_t blockAlign;
+    const std::size_t blockSize;
+    const std::size_t blocksPerSlab;
+    FreeBlock* freeList = nullptr;
+    std::byte* carve = nullptr; // Next never-used block of the newest slab
+    std::byte* carveEnd = nullptr;
+
+    void addSlab() {
+        const std::size_t bytes = blockSize * blocksPerSlab;
+        carve = static_cast<std::byte*>(::operator new(bytes, std::align_val_t{blockAlign}));
+        carveEnd = carve + bytes;
+        slabCount.fetch_add(1, std::memory_order_relaxed);
+        slabByteCount.fetch_add(bytes, std::memory_order_relaxed);
+    }
+};
+
+template <typename T, bool ThreadCache>
+class TypePool;
+
+// Single-threaded: the pool itself, no lock
+template <typename T>
+class TypePool<T, false> {
+public:
+    static void* allocate() { return pool().allocate(); }
+    static void deallocate(void* pointer) { pool().deallocate(pointer); }
+
+private:
+    // Never destroyed, so containers with static lifetime can still free their nodes at exit
+    static FixedPool& pool() {
+        static FixedPool& instance = *new FixedPool(sizeof(T), alignof(T));
+        return instance;
+    }
+};
+
+// A shared pool behind a mutex, with a per-thread stack of free blocks in front of it
+template <typename T>
+class TypePool<T, true> {
+public:
+    static void* allocate() {
+        if (cacheGone()) {
+            Shared& owner = shared();
+            std::lock_guard lock(owner.mutex);
+            return owner.pool.allocate();
+        }
+        Cache& local = cache();
+        if (!local.head) {
+            local.refill();
+        }
+        --local.count;
+        return std::exchange(local.head, local.head->next);
+    }
+
+    static void deallocate(void* pointer) {
+        if (cacheGone()) {
+            Shared& owner = shared();
+            std::lock_guard lock(owner.mutex);
+            owner.pool.deallocate(pointer);
+            return;
+        }
+        Cache& local = cache();
+        local.head = ::new (pointer) FreeBlock{local.head};
+        if (++local.count > 2 * batchSize) {
+            local.flush(batchSize);
+        }
+    }
+
+private:
+    struct Shared {
+        std::mutex mutex;
+        FixedPool pool{sizeof(T), alignof(T)};
+    };
+
+    static Shared& shared() {
+        static Shared& instance = *new Shared;
+        return instance;
+    }
+
+    struct Cache {
+        FreeBlock* head = nullptr;
+        std::size_t count = 0;
+        Shared& owner = shared();
+
+        ~Cache() {
+            flush(count);
+            cacheGone() = true;
+        }
+
+        void refill() {
+            std::lock_guard lock(owner.mutex);
+            for (std::size_t i = 0; i < batchSize; ++i) {
+                head = ::new (owner.pool.allocate()) FreeBlock{head};
+            }
+            count += batchSize;
+        }
+
+        void flush(std::size_t blocks) {
+            std::lock_guard lock(owner.mutex);
+            for (; blocks > 0 && head; --blocks, --count) {
+                owner.pool.deallocate(std::exchange(head, head->next));
+            }
+        }
+    };
+
+    static Cache& cache() {
+        thread_local Cache instance;
+        return instance;
+    }
+
+    // Set when this thread's Cache has been destroyed; a bool has no destructor, so it can still be read afterwards
+    static bool& cacheGone() {
+        thread_local bool gone = false;
+        return gone;
+    }
+};
+
+} // namespace pool_detail
+
+inline NodePoolStats nodePoolStats() {
+    return {pool_detail::slabCount.load(std::memory_order_relaxed),
+            pool_detail::slabByteCount.load(std::memory_order_relaxed)};
+}
+
+// Standard allocator that serves single objects from the pool of T; arrays go to std::allocator
+template <typename T, bool ThreadCache = true>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = PoolAllocator<U, ThreadCache>;
+    };
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, ThreadCache>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n == 1) {
+            return static_cast<T*>(pool_detail::TypePool<T, ThreadCache>::allocate());
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if (n == 1) {
+            pool_detail::TypePool<T, ThreadCache>::deallocate(pointer);
+        } else {
+            std::allocator<T>{}.deallocate(pointer, n);
+        }
+    }
+
+    // All allocators of one type share the pool, so any of them can free what another allocated
+    template <typename U>
+    bool operator==(const PoolAllocator<U, ThreadCache>&) const noexcept {
+        return true;
+    }
+};
+
+// Base class that routes `new Derived(...)` and `delete` to the pool of Derived (classes derived from Derived
+// again, which may be larger, use the global operator new)
+template <typename Derived, bool ThreadCache = true>
+struct PoolAllocated {
+    static void* operator new(std::size_t size) {
+        if (size != sizeof(Derived)) {
+            return ::operator new(size);
+        }
+        return pool_detail::TypePool<Derived, ThreadCache>::allocate();
+    }
+
+    static void operator delete(void* pointer, std::size_t size) noexcept {
+        if (size != sizeof(Derived)) {
+            ::operator delete(pointer);
+        } else {
+            pool_detail::TypePool<Derived, ThreadCache>::deallocate(pointer);
+        }
+    }
+};
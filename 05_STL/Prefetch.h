@@ -0,0 +1,20 @@
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> // _mm_prefetch
+#endif
+
+// Tells the CPU that the cache line holding address will be read soon, so the load can start before it is needed.
+// GCC and Clang have a builtin for it and MSVC an SSE intrinsic; anywhere else it does nothing, which only loses
+// the speed-up. A prefetch never faults, so address may lie past the end of an array.
+//
+// In C#, this is Sse.Prefetch0 (System.Runtime.Intrinsics.X86).
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Double-ended queue stored in one growable ring buffer.
+//
+// NoobDeque (deque_example_noob.cpp) starts in the middle of a fixed array of 100 ints and runs off either end after
+// 50 pushes on that side. std::deque grows, but keeps its elements in many small blocks (512 bytes in libstdc++)
+// reached through a map of block pointers, so every access goes through two indirections and a plain loop over it
+// cannot be vectorized. RingDeque keeps all elements in a single array that wraps around:
+//
+// - The capacity is a power of two, so the physical slot of element i is (head + i) & (capacity - 1): one add and
+//   one AND, no division and no branch.
+// - push_front moves head back by one, push_back writes behind the last element; both ends are O(1). When the array
+//   is full it doubles and the elements are moved to the start of the new array (amortized O(1)). A queue that
+//   stays the same size (push_back + pop_front) never allocates again.
+// - The elements always form at most two contiguous runs: from head to the end of the array, and the wrapped-around
+//   part at the start. as_spans() returns both as std::span, so bulk I/O (write(), memcpy, a SIMD loop) can work on
+//   the contents without copying them out first.
+//
+// Unlike std::deque, growing moves the elements, so any push may invalidate references and iterators.
+//
+// In C#, Queue<T> is the same kind of ring buffer, though only one end can be pushed.
+template <typename T>
+class RingDeque {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    template <bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const RingDeque, RingDeque>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, size_type index) : owner(owner), index(index) {}
+        operator Iterator<true>() const { return {owner, index}; }
+
+        reference operator*() const { return (*owner)[index]; }
+        pointer operator->() const { return &(*owner)[index]; }
+        reference operator[](difference_type n) const { return (*owner)[index + static_cast<size_type>(n)]; }
+
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        Iterator operator++(int) { return {owner, index++}; }
+        Iterator& operator--() {
+            --index;
+            return *this;
+        }
+        Iterator operator--(int) { return {owner, index--}; }
+        Iterator& operator+=(difference_type n) {
+            index += static_cast<size_type>(n);
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) {
+            index -= static_cast<size_type>(n);
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index == b.index; }
+        friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.index <=> b.index; }
+
+    private:
+        Owner* owner = nullptr;
+        size_type index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    RingDeque() = default;
+
+    explicit RingDeque(size_type initialCapacity) { reserve(initialCapacity); }
+
+    RingDeque(std::initializer_list<T> values) {
+        reserve(values.size());
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+    RingDeque(const RingDeque& other) {
+        reserve(other.count);
+        for (const T& value : other) {
+            push_back(value);
+        }
+    }
+
+    RingDeque(RingDeque&& other) noexcept
+        : slots(std::exchange(other.slots, nullptr)), capacityMask(std::exchange(other.capacityMask, 0)),
+          head(std::exchange(other.head, 0)), count(std::exchange(other.count, 0)) {}
+
+    RingDeque& operator=(RingDeque other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~RingDeque() {
+        clear();
+        deallocate(slots);
+    }
+
+    void swap(RingDeque& other) noexcept {
+        std::swap(slots, other.slots);
+        std::swap(capacityMask, other.capacityMask);
+        std::swap(head, other.head);
+        std::swap(count, other.count);
+    }
+
+    bool empty() const { return count == 0; }
+    size_type size() const { return count; }
+    size_type capacity() const { return slots ? capacityMask + 1 : 0; }
+
+    T& operator[](size_type index) { return slots[(head + index) & capacityMask]; }
+    const T& operator[](size_type index) const { return slots[(head + index) & capacityMask]; }
+
+    T& at(size_type index) {
+        checkIndex(index);
+        return (*this)[index];
+    }
+    const T& at(size_type index) const {
+        checkIndex(index);
+        return (*this)[index];
+    }
+
+    T& front() {
+        requireNotEmpty("front");
+        return slots[head];
+    }
+    const T& front() const {
+        requireNotEmpty("front");
+        return slots[head];
+    }
+    T& back() {
+        requireNotEmpty("back");
+        return (*this)[count - 1];
+    }
+    const T& back() const {
+        requireNotEmpty("back");
+        return (*this)[count - 1];
+    }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, count}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, count}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == capacity()) {
+            // The arguments may refer to an element of this deque, so build the value before the array moves
+            T value(std::forward<Args>(args)...);
+            grow(count + 1);
+            return emplace_back(std::move(value));
+        }
+        T* slot = slots + ((head + count) & capacityMask);
+        std::construct_at(slot, std::forward<Args>(args)...);
+        ++count;
+        return *slot;
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        if (count == capacity()) {
+            // The arguments may refer to an element of this deque, so build the value before the array moves
+            T value(std::forward<Args>(args)...);
+            grow(count + 1);
+            return emplace_front(std::move(value));
+        }
+        const size_type newHead = (head - 1) & capacityMask;
+        T* slot = slots + newHead;
+        std::construct_at(slot, std::forward<Args>(args)...);
+        head = newHead;
+        ++count;
+        return *slot;
+    }
+
+    void pop_back() {
+        requireNotEmpty("pop_back");
+        std::destroy_at(slots + ((head + count - 1) & capacityMask));
+        --count;
+    }
+
+    void pop_front() {
+        requireNotEmpty("pop_front");
+        std::destroy_at(slots + head);
+        head = (head + 1) & capacityMask;
+        --count;
+    }
+
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < count; ++i) {
+                std::destroy_at(&(*this)[i]);
+            }
+        }
+        head = 0;
+        count = 0;
+    }
+
+    // Makes room for at least `wanted` elements, rounded up to a power of two
+    void reserve(size_type wanted) {
+        if (wanted > capacity()) {
+            grow(wanted);
+        }
+    }
+
+    // The contents as (at most) two contiguous runs, in order; the second is empty unless the elements wrap around
+    std::pair<std::span<T>, std::span<T>> as_spans() { return spansOf<T>(); }
+    std::pair<std::span<const T>, std::span<const T>> as_spans() const { return spansOf<const T>(); }
+
+private:
+    T* slots = nullptr;
+    size_type capacityMask = 0; // capacity - 1
+    size_type head = 0;         // Slot of the front element
+    size_type count = 0;
+
+    static T* allocate(size_type n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    static void deallocate(T* pointer) { ::operator delete(pointer, std::align_val_t{alignof(T)}); }
+
+    void grow(size_type wanted) {
+        size_type newCapacity = capacity() ? capacity() * 2 : 8;
+        while (newCapacity < wanted) {
+            newCapacity *= 2;
+        }
+        T* fresh = allocate(newCapacity);
+        // Unwrap: the front element lands in slot 0. Each run moves in one call (a memcpy for trivial types).
+        const auto [first, second] = as_spans();
+        T* next = relocate(first, fresh);
+        relocate(second, next);
+        deallocate(slots);
+        slots = fresh;
+        capacityMask = newCapacity - 1;
+        head = 0;
+    }
+
+    static T* relocate(std::span<T> from, T* to) {
+        T* end;
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            end = std::uninitialized_move(from.begin(), from.end(), to);
+        } else {
+            end = std::uninitialized_copy(from.begin(), from.end(), to);
+        }
+        std::destroy(from.begin(), from.end());
+        return end;
+    }
+
+    template <typename U>
+    std::pair<std::span<U>, std::span<U>> spansOf() const {
+        if (count == 0) {
+            return {};
+        }
+        const size_type firstLength = std::min(count, capacity() - head);
+        return {std::span<U>(slots + head, firstLength), std::span<U>(slots, count - firstLength)};
+    }
+
+    void checkIndex(size_type index) const {
+        if (index >= count) {
+            throw std::out_of_range("RingDeque::at: index out of range");
+        }
+    }
+
+    void requireNotEmpty(const char* operation) const {
+        if (count == 0) {
+            throw std::out_of_range(std::string("RingDeque::") + operation + ": deque is empty");
+        }
+    }
+};
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Spatial indices over 2-D points, for nearest-neighbor, k-nearest and range queries.
+//
+// A std::set orders points along one dimension: by x then y (operator<), or by distance from the origin
+// (PointDistanceComparator in 03_Collections/set_example_complex.cpp). Neither order keeps points that are close to
+// each other together, so a "what is near here" query has to scan a long stretch of the set. A std::unordered_set
+// (MyPoint in 11_unordered_set_example.cpp) can only answer "is this exact point present". Both indices here are
+// built in bulk from a range of points and keep the coordinates in structure-of-arrays form (one array of x, one of
+// y, one of the points' positions in the input), so a query reads contiguous doubles:
+//
+// - KdTree splits the points at the median of the wider side of their bounding box, recursively, down to buckets of
+//   8 points. The tree is implicit: a node is a range of the arrays and its split point is the middle element, so
+//   it needs no child pointers. Queries skip every subtree whose side of the split is too far away. Its cost does
+//   not depend on how the points are distributed.
+// - GridIndex divides the bounding box into square cells (about 2 points per cell by default) and stores the points
+//   sorted by cell, so a cell's points are adjacent. A query visits the cells around the query point, ring by ring.
+//   It is simpler and faster than the tree for evenly spread points, and slower when they are clustered: dense cells
+//   hold many points and sparse areas many empty cells.
+//
+// Queries return positions in the input range, so the caller keeps its own vector of points. A point type is
+// accepted if it has getX()/getY() (Point2D) or public x/y members (MyPoint); coordinates are stored as double.
+//
+// In C#, there is no spatial index in the base library; NetTopologySuite provides an STRtree and a KdTree.
+
+// Coordinates of any point type with getX()/getY() or x/y
+template <typename Point>
+double pointX(const Point& point) {
+    if constexpr (requires { point.getX(); }) {
+        return static_cast<double>(point.getX());
+    } else {
+        return static_cast<double>(point.x);
+    }
+}
+
+template <typename Point>
+double pointY(const Point& point) {
+    if constexpr (requires { point.getY(); }) {
+        return static_cast<double>(point.getY());
+    } else {
+        return static_cast<double>(point.y);
+    }
+}
+
+// Result of a nearest-neighbor query
+struct Neighbor {
+    std::size_t index;      // Position of the point in the input range
+    double distanceSquared; // Squared Euclidean distance to the query point
+};
+
+namespace spatial_detail {
+
+inline bool closer(const Neighbor& a, const Neighbor& b) { return a.distanceSquared < b.distanceSquared; }
+
+// The k best candidates so far, in a max-heap on distance
+class NearestK {
+public:
+    explicit NearestK(std::size_t k) : k(k) { heap.reserve(k + 1); }
+
+    // Squared distance a candidate must beat
+    double limit() const {
+        return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.front().distanceSquared;
+    }
+
+    void offer(std::size_t index, double distanceSquared) {
+        if (distanceSquared >= limit()) {
+            return;
+        }
+        heap.push_back({index, distanceSquared});
+        std::push_heap(heap.begin(), heap.end(), closer);
+        if (heap.size() > k) {
+            std::pop_heap(heap.begin(), heap.end(), closer);
+            heap.pop_back();
+        }
+    }
+
+    std::vector<Neighbor> sorted() && {
+        std::sort_heap(heap.begin(), heap.end(), closer);
+        return std::move(heap);
+    }
+
+private:
+    std::size_t k;
+    std::vector<Neighbor> heap;
+};
+
+// The single best candidate
+class NearestOne {
+public:
+    double limit() const { return best.distanceSquared; }
+
+    void offer(std::size_t index, double distanceSquared) {
+        if (distanceSquared < best.distanceSquared) {
+            best = {index, distanceSquared};
+        }
+    }
+
+    Neighbor result() const { return best; }
+
+private:
+    Neighbor best{0, std::numeric_limits<double>::infinity()};
+};
+
+} // namespace spatial_detail
+
+template <typename Point>
+class KdTree {
+public:
+    static constexpr std::size_t leafSize = 8;
+
+    // Build from a range of points in any order. O(N log N).
+    template <typename It>
+    KdTree(It first, It last) {
+        std::vector<Entry> entries;
+        for (std::size_t i = 0; first != last; ++first, ++i) {
+            entries.push_back({pointX(*first), pointY(*first), static_cast<std::uint32_t>(i)});
+        }
+        axes.resize(entries.size());
+        build(entries, 0, entries.size());
+        xs.reserve(entries.size());
+        ys.reserve(entries.size());
+        ids.reserve(entries.size());
+        for (const Entry& entry : entries) {
+            xs.push_back(entry.x);
+            ys.push_back(entry.y);
+            ids.push_back(entry.id);
+        }
+    }
+
+    explicit KdTree(const std::vector<Point>& points) : KdTree(points.begin(), points.end()) {}
+
+    std::size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+
+    // The point closest to (x, y); throws std::out_of_range if the tree is empty
+    Neighbor nearest(double x, double y) const {
+        if (empty()) {
+            throw std::out_of_range("KdTree::nearest on an empty tree");
+        }
+        spatial_detail::NearestOne best;
+        search(0, size(), x, y, best);
+        return best.result();
+    }
+
+    // The k points closest to (x, y), closest first (fewer if the tree has fewer points)
+    std::vector<Neighbor> nearestK(double x, double y, std::size_t k) const {
+        if (k == 0) {
+            return {};
+        }
+        spatial_detail::NearestK best(k);
+        search(0, size(), x, y, best);
+        return std::move(best).sorted();
+    }
+
+    // Calls f(index) for every point with minX <= x <= maxX and minY <= y <= maxY
+    template <typename F>
+    void forEachInRectangle(double minX, double minY, double maxX, double maxY, F f) const {
+        rectangle(0, size(), minX, minY, maxX, maxY, f);
+    }
+
+    // Calls f(index) for every point within radius of (x, y)
+    template <typename F>
+    void forEachInRadius(double x, double y, double radius, F f) const {
+        circle(0, size(), x, y, radius, f);
+    }
+
+private:
+    struct Entry {
+        double x, y;
+        std::uint32_t id;
+    };
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<std::uint32_t> ids;
+    std::vector<std::uint8_t> axes; // Split axis of the node whose middle element is at this position (1 = y)
+
+    void build(std::vector<Entry>& entries, std::size_t lo, std::size_t hi) {
+        if (hi - lo <= leafSize) {
+            return;
+        }
+        double minX = entries[lo].x, maxX = minX, minY = entries[lo].y, maxY = minY;
+        for (std::size_t i = lo + 1; i < hi; ++i) {
+            minX = std::min(minX, entries[i].x);
+            maxX = std::max(maxX, entries[i].x);
+            minY = std::min(minY, entries[i].y);
+            maxY = std::max(maxY, entries[i].y);
+        }
+        const bool splitY = maxY - minY > maxX - minX;
+        const std::size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(entries.begin() + static_cast<std::ptrdiff_t>(lo),
+                         entries.begin() + static_cast<std::ptrdiff_t>(mid),
+                         entries.begin() + static_cast<std::ptrdiff_t>(hi), [splitY](const Entry& a, const Entry& b) {
+                             return splitY ? a.y < b.y : a.x < b.x;
+                         });
+        axes[mid] = splitY;
+        build(entries, lo, mid);
+        build(entries, mid + 1, hi);
+    }
+
+    // A node is a range [lo, hi). Its middle element is the split point, [lo, mid) holds coordinates <= the split,
+    // (mid, hi) coordinates >= it. Small ranges are buckets that are scanned.
+    template <typename Best>
+    void search(std::size_t lo, std::size_t hi, double x, double y, Best& best) const {
+        if (hi - lo <= leafSize) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                offer(i, x, y, best);
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        offer(mid, x, y, best);
+        const double diff = axes[mid] ? y - ys[mid] : x - xs[mid];
+        // The near side first, then the far side only if the split line is closer than the best so far
+        if (diff < 0) {
+            search(lo, mid, x, y, best);
+            if (diff * diff < best.limit()) {
+                search(mid + 1, hi, x, y, best);
+            }
+        } else {
+            search(mid + 1, hi, x, y, best);
+            if (diff * diff < best.limit()) {
+                search(lo, mid, x, y, best);
+            }
+        }
+    }
+
+    template <typename Best>
+    void offer(std::size_t i, double x, double y, Best& best) const {
+        const double dx = xs[i] - x;
+        const double dy = ys[i] - y;
+        best.offer(ids[i], dx * dx + dy * dy);
+    }
+
+    template <typename F>
+    void rectangle(std::size_t lo, std::size_t hi, double minX, double minY, double maxX, double maxY, F& f) const {
+        auto test = [&](std::size_t i) {
+            if (xs[i] >= minX && xs[i] <= maxX && ys[i] >= minY && ys[i] <= maxY) {
+                f(static_cast<std::size_t>(ids[i]));
+            }
+        };
+        if (hi - lo <= leafSize) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                test(i);
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        test(mid);
+        const double split = axes[mid] ? ys[mid] : xs[mid];
+        if ((axes[mid] ? minY : minX) <= split) {
+            rectangle(lo, mid, minX, minY, maxX, maxY, f);
+        }
+        if ((axes[mid] ? maxY : maxX) >= split) {
+            rectangle(mid + 1, hi, minX, minY, maxX, maxY, f);
+        }
+    }
+
+    template <typename F>
+    void circle(std::size_t lo, std::size_t hi, double x, double y, double radius, F& f) const {
+        auto test = [&](std::size_t i) {
+            const double dx = xs[i] - x;
+            const double dy = ys[i] - y;
+            if (dx * dx + dy * dy <= radius * radius) {
+                f(static_cast<std::size_t>(ids[i]));
+            }
+        };
+        if (hi - lo <= leafSize) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                test(i);
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        test(mid);
+        const double diff = axes[mid] ? y - ys[mid] : x - xs[mid];
+        if (diff <= radius) {
+            circle(lo, mid, x, y, radius, f);
+        }
+        if (diff >= -radius) {
+            circle(mid + 1, hi, x, y, radius, f);
+        }
+    }
+};
+
+template <typename Point>
+class GridIndex {
+public:
+    // Build from a range of points in any order. cellSize 0 picks cells that hold about 2 points on average.
+    template <typename It>
+    GridIndex(It first, It last, double cellSize = 0) {
+        std::vector<double> inX, inY;
+        for (; first != last; ++first) {
+            inX.push_back(pointX(*first));
+            inY.push_back(pointY(*first));
+        }
+        const std::size_t n = inX.size();
+        if (n == 0) {
+            return;
+        }
+        minX = *std::min_element(inX.begin(), inX.end());
+        minY = *std::min_element(inY.begin(), inY.end());
+        const double width = *std::max_element(inX.begin(), inX.end()) - minX;
+        const double height = *std::max_element(inY.begin(), inY.end()) - minY;
+        if (cellSize <= 0) {
+            cellSize = std::sqrt(std::max(width * height, 1e-12) * 2 / static_cast<double>(n));
+        }
+        // At most about 4 cells per point, also for a long thin box or a cell size that is far too small
+        const double maxCells = 4.0 * static_cast<double>(n);
+        cellSize = std::max({cellSize, width / maxCells, height / maxCells, std::sqrt(width * height / maxCells)});
+        cell = cellSize;
+        inverseCell = 1 / cellSize;
+        cols = static_cast<std::size_t>(width * inverseCell) + 1;
+        rows = static_cast<std::size_t>(height * inverseCell) + 1;
+
+        // Counting sort by cell: count, prefix sums, then place
+        std::vector<std::uint32_t> cellOfPoint(n);
+        cellStart.assign(cols * rows + 1, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            cellOfPoint[i] = static_cast<std::uint32_t>(row(inY[i]) * cols + column(inX[i]));
+            ++cellStart[cellOfPoint[i] + 1];
+        }
+        for (std::size_t c = 1; c < cellStart.size(); ++c) {
+            cellStart[c] += cellStart[c - 1];
+        }
+        std::vector<std::uint32_t> next(cellStart.begin(), cellStart.end() - 1);
+        xs.resize(n);
+        ys.resize(n);
+        ids.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint32_t slot = next[cellOfPoint[i]]++;
+            xs[slot] = inX[i];
+            ys[slot] = inY[i];
+            ids[slot] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    GridIndex(const std::vector<Point>& points, double cellSize = 0)
+        : GridIndex(points.begin(), points.end(), cellSize) {}
+
+    std::size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+    double cellSize() const { return cell; }
+    std::size_t cellCount() const { return cols * rows; }
+
+    // The point closest to (x, y); throws std::out_of_range if the grid is empty
+    Neighbor nearest(double x, double y) const {
+        if (empty()) {
+            throw std::out_of_range("GridIndex::nearest on an empty grid");
+        }
+        spatial_detail::NearestOne best;
+        search(x, y, best);
+        return best.result();
+    }
+
+    // The k points closest to (x, y), closest first (fewer if the grid has fewer points)
+    std::vector<Neighbor> nearestK(double x, double y, std::size_t k) const {
+        if (k == 0 || empty()) {
+            return {};
+        }
+        spatial_detail::NearestK best(k);
+        search(x, y, best);
+        return std::move(best).sorted();
+    }
+
+    // Calls f(index) for every point with minX <= x <= maxX and minY <= y <= maxY
+    template <typename F>
+    void forEachInRectangle(double minX, double minY, double maxX, double maxY, F f) const {
+        forEachCellIn(minX, minY, maxX, maxY, [&](std::size_t i) {
+            if (xs[i] >= minX && xs[i] <= maxX && ys[i] >= minY && ys[i] <= maxY) {
+                f(static_cast<std::size_t>(ids[i]));
+            }
+        });
+    }
+
+    // Calls f(index) for every point within radius of (x, y)
+    template <typename F>
+    void forEachInRadius(double x, double y, double radius, F f) const {
+        forEachCellIn(x - radius, y - radius, x + radius, y + radius, [&](std::size_t i) {
+            const double dx = xs[i] - x;
+            const double dy = ys[i] - y;
+            if (dx * dx + dy * dy <= radius * radius) {
+                f(static_cast<std::size_t>(ids[i]));
+            }
+        });
+    }
+
+private:
+    double minX = 0, minY = 0;
+    double cell = 1, inverseCell = 1;
+    std::size_t cols = 0, rows = 0;
+    std::vector<std::uint32_t> cellStart; // Points of cell c are [cellStart[c], cellStart[c + 1])
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<std::uint32_t> ids;
+
+    // Cell coordinates, clamped to the grid
+    std::size_t column(double x) const {
+        const double c = std::floor((x - minX) * inverseCell);
+        return c < 0 ? 0 : std::min(static_cast<std::size_t>(c), cols - 1);
+    }
+
+    std::size_t row(double y) const {
+        const double r = std::floor((y - minY) * inverseCell);
+        return r < 0 ? 0 : std::min(static_cast<std::size_t>(r), rows - 1);
+    }
+
+    template <typename Visit>
+    void forEachCellIn(double fromX, double fromY, double toX, double toY, Visit visit) const {
+        if (empty() || toX < fromX || toY < fromY) {
+            return;
+        }
+        const std::size_t lastRow = row(toY), lastColumn = column(toX);
+        for (std::size_t r = row(fromY); r <= lastRow; ++r) {
+            // The cells of one row are adjacent, so their points are one contiguous run
+            const std::size_t end = cellStart[r * cols + lastColumn + 1];
+            for (std::size_t i = cellStart[r * cols + column(fromX)]; i < end; ++i) {
+                visit(i);
+            }
+        }
+    }
+
+    // Visits the cells around the query ring by ring. A cell in ring r + 1 is at least r cells away from the query
+    // point, so once the best distance is within r cells, no further ring can improve it.
+    template <typename Best>
+    void search(double x, double y, Best& best) const {
+        const auto cx = static_cast<std::ptrdiff_t>(column(x));
+        const auto cy = static_cast<std::ptrdiff_t>(row(y));
+        const auto lastColumn = static_cast<std::ptrdiff_t>(cols) - 1;
+        const auto lastRow = static_cast<std::ptrdiff_t>(rows) - 1;
+        auto scan = [&](std::ptrdiff_t r, std::ptrdiff_t from, std::ptrdiff_t to) {
+            const std::size_t first = static_cast<std::size_t>(r) * cols;
+            const std::size_t end = cellStart[first + static_cast<std::size_t>(to) + 1];
+            for (std::size_t i = cellStart[first + static_cast<std::size_t>(from)]; i < end; ++i) {
+                const double dx = xs[i] - x;
+                const double dy = ys[i] - y;
+                best.offer(ids[i], dx * dx + dy * dy);
+            }
+        };
+        const std::ptrdiff_t maxRing = std::max({cx, cy, lastColumn - cx, lastRow - cy});
+        for (std::ptrdiff_t ring = 0; ring <= maxRing; ++ring) {
+            const std::ptrdiff_t left = std::max<std::ptrdiff_t>(cx - ring, 0);
+            const std::ptrdiff_t right = std::min(cx + ring, lastColumn);
+            // Top and bottom rows of the ring in full, then the left and right cells of the rows between
+            if (cy - ring >= 0) {
+                scan(cy - ring, left, right);
+            }
+            if (ring > 0 && cy + ring <= lastRow) {
+                scan(cy + ring, left, right);
+            }
+            const std::ptrdiff_t top = std::max<std::ptrdiff_t>(cy - ring + 1, 0);
+            const std::ptrdiff_t bottom = std::min(cy + ring - 1, lastRow);
+            for (std::ptrdiff_t r = top; ring > 0 && r <= bottom; ++r) {
+                if (cx - ring >= 0) {
+                    scan(r, cx - ring, cx - ring);
+                }
+                if (cx + ring <= lastColumn) {
+                    scan(r, cx + ring, cx + ring);
+                }
+            }
+            const double reach = static_cast<double>(ring) * cell;
+            if (best.limit() <= reach * reach) {
+                return;
+            }
+        }
+    }
+};
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <future>
 #include <thread>
+#include "../07_Threads_And_Tasks/WorkStealingPool.h"
 
 // Function to compute factorial
 int factorial(int n) {
@@ -18,6 +19,11 @@ int main() {
     // Get the result
     std::cout << "Factorial result: " << result.get() << "\n";
 
+    // std::launch::async starts a new thread per call; a thread pool reuses its threads
+    WorkStealingPool pool(2);
+    std::future<int> pooled = pool.submit(factorial, 6);
+    std::cout << "Factorial on the pool: " << pooled.get() << "\n";
+
     return 0;
 }
 
@@ -25,4 +31,5 @@ int main() {
 Expected Output:
 Computing factorial...
 Factorial result: 120
+Factorial on the pool: 720
 */
\ No newline at end of file
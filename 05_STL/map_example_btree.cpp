@@ -0,0 +1,197 @@
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include "BTreeMap.h"
+#include "Benchmark.h"
+
+// NoobMap from map_example_noob.cpp as the baseline: a fixed array of 100 pairs, searched linearly
+class NoobMap {
+private:
+    struct KeyValuePair {
+        std::string key;
+        int value;
+    };
+
+    KeyValuePair data[100]; // Fixed-size array for simplicity
+    int size;
+
+public:
+    NoobMap() : size(0) {}
+
+    // Unlike the original, refuses the 101st key instead of writing past the end of data
+    bool insert(const std::string& key, int value) {
+        for (int i = 0; i < size; ++i) {
+            if (data[i].key == key) {
+                data[i].value = value;
+                return true;
+            }
+        }
+        if (size == 100) {
+            return false;
+        }
+        data[size++] = {key, value};
+        return true;
+    }
+
+    int get(const std::string& key) const {
+        for (int i = 0; i < size; ++i) {
+            if (data[i].key == key) {
+                return data[i].value;
+            }
+        }
+        return 0; // Default value if key not found
+    }
+};
+
+struct Row {
+    double insert, build, lookup, iterate, range;
+};
+
+// Random inserts, building from sorted input, random lookups, a full in-order walk, and scans of 100 keys
+template <typename Map, typename Build>
+Row measure(const std::vector<std::int64_t>& shuffled, const std::vector<std::pair<std::int64_t, std::int64_t>>& sorted,
+            Build build) {
+    const std::size_t n = shuffled.size();
+    std::int64_t sink = 0;
+    Row row{};
+    {
+        Map map;
+        row.insert = nanosPer(n, [&] {
+            for (std::int64_t key : shuffled) {
+                map[key] = key;
+            }
+        });
+    }
+    Map map;
+    row.build = nanosPer(n, [&] { build(map, sorted); });
+    const std::size_t lookups = std::min<std::size_t>(n, 1'000'000);
+    row.lookup = nanosPer(lookups, [&] {
+        for (std::size_t i = 0; i < lookups; ++i) {
+            sink += map.find(shuffled[i])->second;
+        }
+    });
+    row.iterate = nanosPer(n, [&] {
+        for (const auto& [key, value] : map) {
+            sink += value;
+        }
+    });
+    const std::size_t scans = std::min<std::size_t>(n, 100'000);
+    row.range = nanosPer(scans * 100, [&] {
+        for (std::size_t i = 0; i < scans; ++i) {
+            auto it = map.lower_bound(shuffled[i]);
+            for (int step = 0; step < 100 && it != map.end(); ++step, ++it) {
+                sink += it->second;
+            }
+        }
+    });
+    volatile std::int64_t keep = sink;
+    (void)keep;
+    return row;
+}
+
+void printRow(const char* name, const Row& row) {
+    std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << row.insert << std::setw(10) << row.build << std::setw(10) << row.lookup
+              << std::setw(10) << row.iterate << std::setw(10) << row.range << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Step 1: the same ages as map_example.cpp
+    BTreeMap<std::string, int> ageMap;
+
+    // Insert elements
+    ageMap["Alice"] = 25;
+    ageMap["Bob"] = 30;
+    ageMap["Charlie"] = 35;
+
+    // Access elements
+    std::cout << "Alice's age: " << ageMap["Alice"] << "\n";
+
+    // Iterate over the map (in key order, like std::map)
+    std::cout << "All ages:\n";
+    for (const auto& [name, age] : ageMap) {
+        std::cout << name << ": " << age << "\n";
+    }
+
+    // Step 2: NoobMap stops at 100 entries; BTreeMap just grows
+    NoobMap noob;
+    BTreeMap<std::string, int> people;
+    int accepted = 0;
+    for (int i = 0; i < 1'000; ++i) {
+        const std::string name = "person" + std::to_string(i);
+        accepted += noob.insert(name, i);
+        people[name] = i;
+    }
+    std::cout << "\n1000 people: NoobMap kept " << accepted << ", BTreeMap kept " << people.size() << " (height "
+              << people.height() << ")\n";
+
+    // Range queries: everybody from person500 up to (not including) person503
+    std::cout << "From person500 to person503:";
+    people.forEachInRange("person500", "person503", [](const std::string& name, int) { std::cout << " " << name; });
+    std::cout << "\nupper_bound(\"person998\") is " << people.upper_bound("person998")->first << "\n";
+
+    // Step 3: benchmark, 10^3 up to 10^maxExponent keys (default 10^6; 10^8 needs about 8 GB for std::map)
+    const int maxExponent = argc > 1 ? std::atoi(argv[1]) : 6;
+    std::cout << "\nns per key (int64 keys and values; build = from sorted input; range = per key of 100-key scans)\n";
+    std::cout << "  " << std::left << std::setw(10) << "" << std::right << std::setw(10) << "insert" << std::setw(10)
+              << "build" << std::setw(10) << "lookup" << std::setw(10) << "iterate" << std::setw(10) << "range"
+              << "\n";
+    std::mt19937_64 random(7);
+    std::size_t n = 1'000;
+    for (int exponent = 3; exponent <= maxExponent; ++exponent, n *= 10) {
+        std::vector<std::pair<std::int64_t, std::int64_t>> sorted(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            sorted[i] = {static_cast<std::int64_t>(i) * 3, static_cast<std::int64_t>(i)};
+        }
+        std::vector<std::int64_t> shuffled(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            shuffled[i] = sorted[i].first;
+        }
+        std::shuffle(shuffled.begin(), shuffled.end(), random);
+
+        std::cout << "10^" << exponent << " keys\n";
+        printRow("std::map", measure<std::map<std::int64_t, std::int64_t>>(shuffled, sorted, [](auto& map, auto& in) {
+                     map = std::map<std::int64_t, std::int64_t>(in.begin(), in.end()); // Linear for sorted input
+                 }));
+        printRow("BTreeMap", measure<BTreeMap<std::int64_t, std::int64_t>>(
+                                 shuffled, sorted, [](auto& map, auto& in) { map.bulkLoad(in.begin(), in.end()); }));
+    }
+
+    return 0;
+}
+
+/*
+Sample Output (timings vary by machine; these come from a single-core x86-64 machine, default sizes up to 10^6.
+Run with 7 or 8 as the argument for larger maps; 10^8 keys needs about 8 GB for std::map):
+Alice's age: 25
+All ages:
+Alice: 25
+Bob: 30
+Charlie: 35
+
+1000 people: NoobMap kept 100, BTreeMap kept 1000 (height 5)
+From person500 to person503: person500 person501 person502
+upper_bound("person998") is person999
+
+ns per key (int64 keys and values; build = from sorted input; range = per key of 100-key scans)
+                insert     build    lookup   iterate     range
+10^3 keys
+  std::map       195.5      75.3      92.4      11.0       8.1
+  BTreeMap       117.1       6.4      94.2       1.1       1.9
+10^4 keys
+  std::map       271.8      75.4     168.7      15.9      13.7
+  BTreeMap       159.6       3.6     125.4       0.8       1.9
+10^5 keys
+  std::map       377.6     124.9     510.8      74.5      51.1
+  BTreeMap       233.2       4.1     159.7       0.8       2.4
+10^6 keys
+  std::map      1086.0     310.0    1439.6     230.3     244.6
+  BTreeMap       598.1       6.8     435.9       2.1       6.8
+*/
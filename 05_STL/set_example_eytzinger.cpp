@@ -0,0 +1,180 @@
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include "EytzingerSet.h"
+#include "Benchmark.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Size in bytes of the level 1, 2 or 3 data cache as reported by glibc, or a typical value on other systems or when
+// it does not know
+std::size_t cacheBytes(int level, std::size_t fallback) {
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    const int names[] = {_SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE};
+    const long bytes = sysconf(names[level - 1]);
+    if (bytes > 0) {
+        return static_cast<std::size_t>(bytes);
+    }
+#else
+    (void)level;
+#endif
+    return fallback;
+}
+
+struct Level {
+    std::string name;
+    std::size_t bytes; // Size of the int array searched at this level
+};
+
+// Million lookups per second; each query is independent, so the CPU can overlap several of them
+template <typename Contains>
+double throughput(const std::vector<int>& queries, Contains contains) {
+    std::size_t hits = 0;
+    const double nanos = nanosPer(queries.size(), [&] {
+        for (int key : queries) {
+            hits += contains(key);
+        }
+    });
+    volatile std::size_t keep = hits;
+    (void)keep;
+    return 1'000.0 / nanos;
+}
+
+void printRow(const char* name, const std::vector<double>& row) {
+    std::cout << "  " << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(1);
+    for (double value : row) {
+        if (value > 0) {
+            std::cout << std::setw(10) << value;
+        } else {
+            std::cout << std::setw(10) << "-";
+        }
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Step 1: the same numbers as set_example.cpp, in a set that is built once
+    const EytzingerSet<int> uniqueNumbers = {5, 3, 8, 3, 1, 2};
+
+    // Iterate over the set (in sorted order, like std::set)
+    std::cout << "Unique numbers: ";
+    for (int const& num : uniqueNumbers) {
+        std::cout << num << " ";
+    }
+    std::cout << "\n";
+
+    std::cout << "Contains 3? " << (uniqueNumbers.contains(3) ? "Yes" : "No") << ", count of 4: "
+              << uniqueNumbers.count(4) << "\n";
+    std::cout << "lower_bound(4) is " << *uniqueNumbers.lower_bound(4) << ", upper_bound(5) is "
+              << *uniqueNumbers.upper_bound(5) << "\n";
+    std::cout << "From 2 up to 8:";
+    for (auto it = uniqueNumbers.lower_bound(2); it != uniqueNumbers.lower_bound(8); ++it) {
+        std::cout << " " << *it;
+    }
+    std::cout << "\n";
+
+    // Step 2: any comparator, as with std::set<int, std::greater<int>>
+    const EytzingerSet<std::string, std::greater<std::string>> descending = {"pear", "apple", "fig", "kiwi"};
+    std::cout << "Descending:";
+    for (const std::string& fruit : descending) {
+        std::cout << " " << fruit;
+    }
+    std::cout << "; first not after \"grape\": " << *descending.lower_bound("grape") << "\n";
+
+    // Step 3: lookup throughput for sets that fill about half of L1, L2 and L3, and one that only fits in DRAM
+    // (argv[1]: its size in MB, default 4 x L3 up to 512 MB)
+    const std::size_t l3 = cacheBytes(3, 32u << 20);
+    const std::size_t dramBytes =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) << 20 : std::min<std::size_t>(4 * l3, 512u << 20);
+    const std::vector<Level> levels = {{"L1", cacheBytes(1, 32u << 10) / 2},
+                                       {"L2", cacheBytes(2, 1u << 20) / 2},
+                                       {"L3", l3 / 2},
+                                       {"DRAM", dramBytes}};
+    // std::set spends about 40 bytes per int; it is left out where that would not fit in memory comfortably
+    const std::size_t maxStdSet = 16'000'000;
+
+    std::cout << "\nMillion lookups per second (int keys, half of the lookups miss; - = not run)\n";
+    std::cout << "  " << std::left << std::setw(30) << "" << std::right;
+    for (const Level& level : levels) {
+        std::cout << std::setw(10) << level.name;
+    }
+    std::cout << "\n  " << std::left << std::setw(30) << "ints in the set" << std::right;
+    for (const Level& level : levels) {
+        std::cout << std::setw(10) << level.bytes / sizeof(int);
+    }
+    std::cout << "\n";
+
+    std::vector<double> stdSet, lowerBound, branchless, noPrefetch, eytzinger;
+    std::mt19937 random(5);
+    for (const Level& level : levels) {
+        const std::size_t n = level.bytes / sizeof(int);
+        // The even numbers below 2n; queries are any number below 2n
+        std::vector<int> values(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            values[i] = static_cast<int>(2 * i);
+        }
+        std::vector<int> queries(4'000'000);
+        for (int& key : queries) {
+            key = static_cast<int>(random() % (2 * n));
+        }
+
+        if (n <= maxStdSet) {
+            const std::set<int> set(values.begin(), values.end());
+            stdSet.push_back(throughput(queries, [&](int key) { return set.contains(key); }));
+        } else {
+            stdSet.push_back(0);
+        }
+        {
+            const EytzingerSet<int> set(values.begin(), values.end());
+            eytzinger.push_back(throughput(queries, [&](int key) { return set.contains(key); }));
+        }
+        {
+            const EytzingerSet<int, std::less<int>, false> set(values.begin(), values.end());
+            noPrefetch.push_back(throughput(queries, [&](int key) { return set.contains(key); }));
+        }
+        lowerBound.push_back(throughput(queries, [&](int key) {
+            const auto it = std::lower_bound(values.begin(), values.end(), key);
+            return it != values.end() && *it == key;
+        }));
+        branchless.push_back(throughput(queries, [&](int key) {
+            const auto it = branchlessLowerBound(values.begin(), values.end(), key);
+            return it != values.end() && *it == key;
+        }));
+    }
+    printRow("std::set", stdSet);
+    printRow("std::lower_bound on a vector", lowerBound);
+    printRow("branchlessLowerBound", branchless);
+    printRow("EytzingerSet without prefetch", noPrefetch);
+    printRow("EytzingerSet", eytzinger);
+
+    return 0;
+}
+
+/*
+Sample Output (timings vary by machine; these come from a single-core x86-64 virtual machine that reports a 300 MB L3
+shared with the rest of its host, so the L3 column is mostly not cache-resident either, and every miss there also
+misses the TLB; prefetching the slots four levels ahead is what pays off at those sizes):
+Unique numbers: 1 2 3 5 8 
+Contains 3? Yes, count of 4: 0
+lower_bound(4) is 5, upper_bound(5) is 8
+From 2 up to 8: 2 3 5
+Descending: pear kiwi fig apple; first not after "grape": fig
+
+Million lookups per second (int keys, half of the lookups miss; - = not run)
+                                        L1        L2        L3      DRAM
+  ints in the set                     6144    262144  39321600 134217728
+  std::set                             6.2       1.3         -         -
+  std::lower_bound on a vector         8.5       4.5       1.2       0.8
+  branchlessLowerBound                37.8      11.6       1.1       0.7
+  EytzingerSet without prefetch       18.6      12.3       1.2       0.8
+  EytzingerSet                        18.0      12.3       2.7       2.0
+*/
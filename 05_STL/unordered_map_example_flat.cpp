@@ -0,0 +1,239 @@
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <functional>
+#include "FlatHashMap.h"
+
+// NoobHashMap from unordered_map_example_noob.cpp, with an erase, as the baseline
+class NoobHashMap {
+private:
+    struct KeyValuePair {
+        std::string key;
+        int value;
+    };
+
+    std::vector<KeyValuePair> data;
+
+public:
+    void insert(const std::string& key, int value) {
+        for (auto& pair : data) {
+            if (pair.key == key) {
+                pair.value = value;
+                return;
+            }
+        }
+        data.push_back({key, value});
+    }
+
+    int get(const std::string& key) const {
+        for (const auto& pair : data) {
+            if (pair.key == key) {
+                return pair.value;
+            }
+        }
+        return 0; // Default value if key not found
+    }
+
+    void erase(const std::string& key) {
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            if (it->key == key) {
+                data.erase(it);
+                return;
+            }
+        }
+    }
+};
+
+// The three maps behind one interface, so every workload runs the same code on each
+struct NoobAdapter {
+    NoobHashMap map;
+    void insert(const std::string& key, int value) { map.insert(key, value); }
+    int get(const std::string& key) { return map.get(key); }
+    void erase(const std::string& key) { map.erase(key); }
+};
+
+struct StdAdapter {
+    std::unordered_map<std::string, int> map;
+    void insert(const std::string& key, int value) { map.insert_or_assign(key, value); }
+    int get(const std::string& key) {
+        auto it = map.find(key);
+        return it == map.end() ? 0 : it->second;
+    }
+    void erase(const std::string& key) { map.erase(key); }
+};
+
+struct FlatAdapter {
+    FlatHashMap<std::string, int> map;
+    void insert(const std::string& key, int value) { map.insert_or_assign(key, value); }
+    int get(const std::string& key) {
+        auto it = map.find(key);
+        return it == map.end() ? 0 : it->second;
+    }
+    void erase(const std::string& key) { map.erase(key); }
+};
+
+std::vector<std::string> makeKeys(std::size_t count, const char* prefix) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys.push_back(prefix + std::to_string(i * 2654435761u % 1'000'000'007u));
+    }
+    return keys;
+}
+
+struct Timings {
+    double insert, hit, miss, churn, mixed; // ns per operation
+};
+
+template <typename Map>
+Timings runWorkloads(const std::vector<std::string>& keys, const std::vector<std::string>& absent,
+                     const std::vector<std::string>& fresh) {
+    auto nanosPerOp = [](std::size_t operations, const std::function<void()>& body) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(operations);
+    };
+    const std::size_t n = keys.size();
+    Map map;
+    long long sink = 0;
+    Timings t{};
+    t.insert = nanosPerOp(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            map.insert(keys[i], static_cast<int>(i));
+        }
+    });
+    t.hit = nanosPerOp(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            sink += map.get(keys[(i * 7919) % n]);
+        }
+    });
+    t.miss = nanosPerOp(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            sink += map.get(absent[i]);
+        }
+    });
+    // Erase-heavy: replace every key by a new one, so the map keeps its size while everything churns
+    t.churn = nanosPerOp(2 * n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            map.erase(keys[i]);
+            map.insert(fresh[i], static_cast<int>(i));
+        }
+    });
+    // 50% lookups, 25% inserts, 25% erases, in random order
+    std::mt19937 random(42);
+    t.mixed = nanosPerOp(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t r = random();
+            const std::string& key = (r & 1) ? fresh[(r >> 3) % n] : keys[(r >> 3) % n];
+            switch ((r >> 1) & 3) {
+            case 0:
+            case 1:
+                sink += map.get(key);
+                break;
+            case 2:
+                map.insert(key, static_cast<int>(i));
+                break;
+            default:
+                map.erase(key);
+            }
+        }
+    });
+    volatile long long keep = sink;
+    (void)keep;
+    return t;
+}
+
+void printRow(const char* name, const Timings& t) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << t.insert << std::setw(10) << t.hit << std::setw(10) << t.miss << std::setw(10)
+              << t.churn << std::setw(10) << t.mixed << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Step 1: the same word count as unordered_map_example.cpp
+    FlatHashMap<std::string, int> wordCount;
+
+    // Insert elements
+    wordCount["hello"] = 1;
+    wordCount["world"] = 2;
+
+    // Access elements
+    std::cout << "Count of 'hello': " << wordCount["hello"] << "\n";
+
+    // Iterate over the FlatHashMap (in slot order, like unordered_map the order is unspecified)
+    std::cout << "Word counts:\n";
+    for (const auto& [word, count] : wordCount) {
+        std::cout << word << ": " << count << "\n";
+    }
+
+    // Step 2: heterogeneous lookup. The words are string_views into the text; only new words become strings.
+    const std::string text = "the quick brown fox jumps over the lazy dog the end";
+    FlatHashMap<std::string, int> counts;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        const std::size_t end = std::min(text.find(' ', start), text.size());
+        const std::string_view word(text.data() + start, end - start);
+        if (auto it = counts.find(word); it != counts.end()) {
+            ++it->second; // No std::string built for a word we have seen
+        } else {
+            counts.try_emplace(std::string(word), 1);
+        }
+        start = end + 1;
+    }
+    std::cout << "\n'the' appears " << counts.at(std::string_view("the")) << " times in \"" << text << "\"\n";
+    counts.erase("the");
+    std::cout << "After erase: contains 'the'? " << std::boolalpha << counts.contains("the") << ", " << counts.size()
+              << " distinct words left\n";
+
+    // Step 3: benchmark. The noob map is O(N) per operation, so it only runs on the small size.
+    const std::size_t large = argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 200'000;
+    const std::size_t noobLimit = 5'000;
+    std::cout << "\nns per operation (string keys; churn = erase + insert; mixed = 50% find, 25% insert, 25% erase)\n";
+    for (std::size_t n : {noobLimit, large}) {
+        const auto keys = makeKeys(n, "key");
+        const auto absent = makeKeys(n, "absent");
+        const auto fresh = makeKeys(n, "fresh");
+        std::cout << "\nN = " << n << "\n";
+        std::cout << std::left << std::setw(22) << "map" << std::right << std::setw(10) << "insert" << std::setw(10)
+                  << "find hit" << std::setw(10) << "find miss" << std::setw(10) << "churn" << std::setw(10)
+                  << "mixed" << "\n";
+        if (n <= noobLimit) {
+            printRow("NoobHashMap", runWorkloads<NoobAdapter>(keys, absent, fresh));
+        }
+        printRow("std::unordered_map", runWorkloads<StdAdapter>(keys, absent, fresh));
+        printRow("FlatHashMap", runWorkloads<FlatAdapter>(keys, absent, fresh));
+    }
+
+    return 0;
+}
+
+/*
+Sample Output (timings vary by machine; these come from a single-core x86-64 machine with SSE2):
+Count of 'hello': 1
+Word counts:
+world: 2
+hello: 1
+
+'the' appears 3 times in "the quick brown fox jumps over the lazy dog the end"
+After erase: contains 'the'? false, 8 distinct words left
+
+ns per operation (string keys; churn = erase + insert; mixed = 50% find, 25% insert, 25% erase)
+
+N = 5000
+map                       insert  find hit find miss     churn     mixed
+NoobHashMap              12210.7   12413.8    4161.3   22918.1   11133.1
+std::unordered_map         139.4      54.6      57.7      80.7     109.5
+FlatHashMap                184.2      35.4      23.9     103.9      82.7
+
+N = 200000
+map                       insert  find hit find miss     churn     mixed
+std::unordered_map         419.1     183.8     175.3     344.6     395.2
+FlatHashMap                428.7     165.8      28.6     166.3     228.0
+*/
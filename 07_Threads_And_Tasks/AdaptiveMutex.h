@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "SpinWait.h"
+
+// Spin-then-park locks built on one atomic word.
+//
+// std::mutex goes to the kernel as soon as the lock is taken (a futex wait), and its owner pays another system call
+// to wake the waiter. When the critical section is a push_back or a counter increment, the lock is free again long
+// before the waiter has even gone to sleep. AdaptiveMutex first spins with bounded exponential backoff (SpinWait.h)
+// and only parks on std::atomic::wait once the backoff is spent:
+//
+// - The word is 0 (free), 1 (locked) or 2 (locked, and someone may be parked) (Drepper, "Futexes Are Tricky").
+//   unlock() only makes a wake-up call when it sees 2, so an uncontended lock/unlock is two atomic operations.
+//
+// SharedMutex is a reader-writer lock that prefers writers: once a writer asks for the lock, new readers wait until
+// every waiting writer has had its turn, so a steady stream of readers cannot starve writers (std::shared_mutex does
+// not promise either way).
+//
+// Both work with std::lock_guard, std::unique_lock and std::shared_lock.
+//
+// In C#, this is what Monitor (lock) does before it blocks, and ReaderWriterLockSlim.
+
+class AdaptiveMutex {
+public:
+    AdaptiveMutex() = default;
+    AdaptiveMutex(const AdaptiveMutex&) = delete;
+    AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+    void lock() {
+        std::uint32_t expected = unlocked;
+        if (state.compare_exchange_strong(expected, locked, std::memory_order_acquire)) {
+            return;
+        }
+        // Spin while the owner is likely to be almost done; only read the word so the cache line stays shared
+        SpinWait spin;
+        while (spin.spinOnce()) {
+            if (state.load(std::memory_order_relaxed) == unlocked) {
+                expected = unlocked;
+                if (state.compare_exchange_weak(expected, locked, std::memory_order_acquire)) {
+                    return;
+                }
+            }
+        }
+        // Park. Whoever takes the lock from here on marks it contended, as there may be other sleepers
+        while (state.exchange(contended, std::memory_order_acquire) != unlocked) {
+            state.wait(contended, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_lock() {
+        std::uint32_t expected = unlocked;
+        return state.compare_exchange_strong(expected, locked, std::memory_order_acquire);
+    }
+
+    void unlock() {
+        if (state.exchange(unlocked, std::memory_order_release) == contended) {
+            state.notify_one();
+        }
+    }
+
+private:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t contended = 2;
+
+    std::atomic<std::uint32_t> state{unlocked};
+};
+
+class SharedMutex {
+public:
+    SharedMutex() = default;
+    SharedMutex(const SharedMutex&) = delete;
+    SharedMutex& operator=(const SharedMutex&) = delete;
+
+    // Exclusive. Announcing the writer first keeps new readers out; writers then take turns on writerMutex and wait
+    // for the readers that were already inside to leave.
+    void lock() {
+        state.fetch_add(oneWriter, std::memory_order_relaxed);
+        writerMutex.lock();
+        waitUntil([](std::uint32_t s) { return readers(s) == 0; });
+    }
+
+    bool try_lock() {
+        std::uint32_t expected = 0;
+        if (!state.compare_exchange_strong(expected, oneWriter, std::memory_order_acquire)) {
+            return false;
+        }
+        writerMutex.lock(); // Free: writers release it before they leave the count
+        return true;
+    }
+
+    void unlock() {
+        writerMutex.unlock();
+        const std::uint32_t previous = state.fetch_sub(oneWriter, std::memory_order_release);
+        if (writers(previous) == 1) {
+            state.notify_all(); // Last writer out: let the readers in
+        }
+    }
+
+    // Shared: enter only while no writer is waiting or writing
+    void lock_shared() {
+        std::uint32_t s = state.load(std::memory_order_relaxed);
+        for (;;) {
+            if (writers(s) == 0) {
+                if (state.compare_exchange_weak(s, s + oneReader, std::memory_order_acquire)) {
+                    return;
+                }
+                continue; // s was reloaded by the failed exchange
+            }
+            waitUntil([](std::uint32_t value) { return writers(value) == 0; }, std::memory_order_relaxed);
+            s = state.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool try_lock_shared() {
+        std::uint32_t s = state.load(std::memory_order_relaxed);
+        while (writers(s) == 0) {
+            if (state.compare_exchange_weak(s, s + oneReader, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void unlock_shared() {
+        const std::uint32_t previous = state.fetch_sub(oneReader, std::memory_order_release);
+        if (readers(previous) == 1 && writers(previous) != 0) {
+            state.notify_all(); // Last reader out while a writer waits for us
+        }
+    }
+
+private:
+    // Low 20 bits count the readers inside, the bits above count the writers waiting or writing
+    static constexpr std::uint32_t oneReader = 1;
+    static constexpr std::uint32_t oneWriter = 1u << 20;
+
+    static std::uint32_t readers(std::uint32_t s) { return s & (oneWriter - 1); }
+    static std::uint32_t writers(std::uint32_t s) { return s >> 20; }
+
+    // Spin, then park, until done(state) holds
+    template <typename Condition>
+    void waitUntil(Condition done, std::memory_order order = std::memory_order_acquire) {
+        SpinWait spin;
+        std::uint32_t s = state.load(order);
+        while (!done(s)) {
+            if (!spin.spinOnce()) {
+                state.wait(s, std::memory_order_relaxed);
+            }
+            s = state.load(order);
+        }
+    }
+
+    std::atomic<std::uint32_t> state{0};
+    AdaptiveMutex writerMutex;
+};
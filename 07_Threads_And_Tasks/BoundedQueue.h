@@ -0,0 +1,298 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "SpinWait.h"
+
+// Bounded lock-free queues for producer/consumer hand-off.
+//
+// threads_example.cpp coordinates threads with one std::mutex and a condition_variable. For a queue that means every
+// push and every pop takes the same lock, and every wake-up is a system call. These queues avoid the lock:
+//
+// - MpmcQueue (Dmitry Vyukov's bounded MPMC queue): a ring of cells, each with a sequence number that says whether
+//   the cell is ready to be written or read in the current lap. A producer claims a position with one CAS on the
+//   enqueue counter, writes the value and publishes it by bumping the cell's sequence; consumers do the same on the
+//   dequeue counter. Producers and consumers never touch the same counter.
+// - SpscQueue: with a single producer and a single consumer no CAS is needed at all. Each side owns its index and
+//   keeps a cached copy of the other side's index, so it only reads the shared one when the cache says full/empty.
+//   tryPush/tryPop are wait-free: they finish in a few steps whatever the other thread is doing. The batch
+//   versions move many values but publish them with one index store, so the cache line holding the index crosses
+//   between the cores once per batch instead of once per value.
+//
+// Both are non-blocking (tryPush/tryPop fail when full/empty). BlockingQueue adds push/pop that spin briefly and
+// then park on an atomic (futex on Linux) until the other side makes progress.
+//
+// In C#, this is ConcurrentQueue<T> and BlockingCollection<T> with a bounded capacity.
+
+namespace detail {
+
+inline std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace detail
+
+// Multi-producer multi-consumer; T must be default-constructible and movable
+template <typename T>
+class MpmcQueue {
+public:
+    using value_type = T;
+
+    explicit MpmcQueue(std::size_t capacity)
+        : mask(detail::roundUpToPowerOfTwo(capacity) - 1), cells(std::make_unique<Cell[]>(mask + 1)) {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // Returns false when full; value is only moved from on success
+    template <typename U>
+    bool tryPush(U&& value) {
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                // The cell is free in this lap: try to claim the position
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // The cell still holds a value from the previous lap
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed); // Another producer got there first
+            }
+        }
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(position + 1, std::memory_order_release); // Publish to consumers
+        return true;
+    }
+
+    // Returns false when empty
+    bool tryPop(T& value) {
+        std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // Not written yet
+            } else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->value);
+        cell->sequence.store(position + mask + 1, std::memory_order_release); // Free for the next lap
+        return true;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    const std::size_t mask;
+    const std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<std::size_t> enqueuePosition{0};
+    alignas(64) std::atomic<std::size_t> dequeuePosition{0};
+};
+
+// Single-producer single-consumer: tryPush from one thread only, tryPop from one (other) thread only
+template <typename T>
+class SpscQueue {
+public:
+    using value_type = T;
+
+    explicit SpscQueue(std::size_t capacity)
+        : mask(detail::roundUpToPowerOfTwo(capacity) - 1), slots(std::make_unique<T[]>(mask + 1)) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    template <typename U>
+    bool tryPush(U&& value) {
+        const std::size_t tail = producer.index.load(std::memory_order_relaxed);
+        if (tail - producer.cachedOther > mask) {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire); // Looks full: check for real
+            if (tail - producer.cachedOther > mask) {
+                return false;
+            }
+        }
+        slots[tail & mask] = std::forward<U>(value);
+        producer.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        const std::size_t head = consumer.index.load(std::memory_order_relaxed);
+        if (head == consumer.cachedOther) {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire); // Looks empty: check for real
+            if (head == consumer.cachedOther) {
+                return false;
+            }
+        }
+        value = std::move(slots[head & mask]);
+        consumer.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Moves up to count values from first into the queue; returns how many fit
+    template <typename InputIt>
+    std::size_t tryPushBatch(InputIt first, std::size_t count) {
+        const std::size_t tail = producer.index.load(std::memory_order_relaxed);
+        std::size_t room = mask + 1 - (tail - producer.cachedOther);
+        if (room < count) {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire);
+            room = mask + 1 - (tail - producer.cachedOther);
+        }
+        const std::size_t pushed = room < count ? room : count;
+        for (std::size_t i = 0; i < pushed; ++i, ++first) {
+            slots[(tail + i) & mask] = std::move(*first);
+        }
+        if (pushed > 0) {
+            producer.index.store(tail + pushed, std::memory_order_release);
+        }
+        return pushed;
+    }
+
+    // Moves up to maxCount values to out; returns how many there were
+    template <typename OutputIt>
+    std::size_t tryPopBatch(OutputIt out, std::size_t maxCount) {
+        const std::size_t head = consumer.index.load(std::memory_order_relaxed);
+        std::size_t available = consumer.cachedOther - head;
+        if (available < maxCount) {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire);
+            available = consumer.cachedOther - head;
+        }
+        const std::size_t popped = available < maxCount ? available : maxCount;
+        for (std::size_t i = 0; i < popped; ++i, ++out) {
+            *out = std::move(slots[(head + i) & mask]);
+        }
+        if (popped > 0) {
+            consumer.index.store(head + popped, std::memory_order_release);
+        }
+        return popped;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    // Each side's index and its cached copy of the other side's index share one cache line, owned by that side
+    struct alignas(64) Side {
+        std::atomic<std::size_t> index{0};
+        std::size_t cachedOther = 0;
+    };
+
+    const std::size_t mask;
+    const std::unique_ptr<T[]> slots;
+    Side producer; // tail
+    Side consumer; // head
+};
+
+// Blocking push/pop on top of MpmcQueue or SpscQueue: spin with backoff, then park until the other side signals
+template <typename Queue>
+class BlockingQueue {
+public:
+    using value_type = typename Queue::value_type;
+
+    explicit BlockingQueue(std::size_t capacity) : queue(capacity) {}
+
+    // U&& is only moved from by the attempt that succeeds
+    template <typename U>
+    void push(U&& value) {
+        SpinWait spin;
+        while (!queue.tryPush(std::forward<U>(value))) {
+            if (!spin.spinOnce()) {
+                if (park(notFull, producersSleeping, [&] { return queue.tryPush(std::forward<U>(value)); })) {
+                    break;
+                }
+                spin.reset();
+            }
+        }
+        signal(notEmpty, consumersSleeping);
+    }
+
+    value_type pop() {
+        value_type value;
+        SpinWait spin;
+        while (!queue.tryPop(value)) {
+            if (!spin.spinOnce()) {
+                if (park(notEmpty, consumersSleeping, [&] { return queue.tryPop(value); })) {
+                    break;
+                }
+                spin.reset();
+            }
+        }
+        signal(notFull, producersSleeping);
+        return value;
+    }
+
+    template <typename U>
+    bool tryPush(U&& value) {
+        if (!queue.tryPush(std::forward<U>(value))) {
+            return false;
+        }
+        signal(notEmpty, consumersSleeping);
+        return true;
+    }
+
+    bool tryPop(value_type& value) {
+        if (!queue.tryPop(value)) {
+            return false;
+        }
+        signal(notFull, producersSleeping);
+        return true;
+    }
+
+    std::size_t capacity() const { return queue.capacity(); }
+
+private:
+    // Raise the flag, then retry once before sleeping. Together with signal() no wake-up is lost: either the retry
+    // sees the other side's progress, or the other side sees the flag and bumps the epoch.
+    template <typename Retry>
+    static bool park(std::atomic<std::uint32_t>& epoch, std::atomic<bool>& sleeping, Retry&& retry) {
+        sleeping.store(true);
+        const std::uint32_t seen = epoch.load();
+        if (retry()) {
+            return true;
+        }
+        epoch.wait(seen);
+        return false;
+    }
+
+    // Costs a fence and a load while nobody sleeps. The exchange makes sure only the first operation after a
+    // sleeper arrived pays for the wake-up system call, instead of every operation until the sleeper runs.
+    static void signal(std::atomic<std::uint32_t>& epoch, std::atomic<bool>& sleeping) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false)) {
+            epoch.fetch_add(1);
+            epoch.notify_all(); // Every sleeper retries; the losers raise the flag again
+        }
+    }
+
+    std::atomic<std::uint32_t> notEmpty{0};
+    std::atomic<std::uint32_t> notFull{0};
+    std::atomic<bool> consumersSleeping{false};
+    std::atomic<bool> producersSleeping{false};
+    Queue queue;
+};
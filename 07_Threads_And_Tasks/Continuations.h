@@ -0,0 +1,311 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Promise/Future pair with continuations.
+//
+// std::future only offers get()/wait(), so the only way to run B after A is to block some thread in A.get().
+// Here a Future<T> can instead be given a continuation:
+//
+//   asyncOn(pool, longRunningTask, 10)
+//       .then(pool, [](int x) { return longRunningTask(x); })
+//       .then(pool, [](int x) { std::cout << x; });
+//
+// Nothing waits: when A's promise is fulfilled, the continuation is posted to the executor given to then().
+// whenAll() and whenAny() combine several futures the same way, using an atomic counter or flag instead of a thread.
+//
+// A promise that is destroyed (with all its copies) before it is fulfilled completes its future with
+// std::future_error(broken_promise), like std::promise, so no continuation or get() waits forever.
+//
+// An executor is anything with a post(callable) member, e.g. WorkStealingPool, or InlineExecutor which runs the
+// continuation right away on the thread that fulfilled the promise.
+//
+// In C#, this is Task.ContinueWith, Task.WhenAll and Task.WhenAny.
+
+// Future<void> would need special cases everywhere; continuations that return nothing produce Future<Unit>
+using Unit = std::monostate;
+
+template <typename T>
+class Future;
+
+// Runs a continuation immediately on the completing thread; good for very cheap continuations
+struct InlineExecutor {
+    template <typename F>
+    void post(F&& f) const { std::forward<F>(f)(); }
+};
+
+namespace detail {
+
+template <typename T>
+struct SharedState {
+    std::mutex mutex;
+    std::condition_variable readyCondition; // Only used by the blocking get()/wait()
+    bool ready = false;
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::vector<std::function<void()>> continuations;
+
+    // Store the result and schedule every continuation registered so far
+    template <typename Setter>
+    void complete(Setter&& setter) {
+        std::vector<std::function<void()>> toRun;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ready) {
+                return; // Already satisfied (e.g. the losers of whenAny)
+            }
+            setter(*this);
+            ready = true;
+            toRun.swap(continuations);
+        }
+        readyCondition.notify_all();
+        for (auto& continuation : toRun) {
+            continuation();
+        }
+    }
+
+    // Run the callback now if ready, otherwise when the state completes
+    void onReady(std::function<void()> callback) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!ready) {
+                continuations.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+};
+
+// Shared by a Promise and its copies (continuations capture promises by value); the last copy to go breaks the
+// promise if nobody fulfilled it
+template <typename T>
+struct PromiseOwner {
+    std::shared_ptr<SharedState<T>> state = std::make_shared<SharedState<T>>();
+
+    PromiseOwner() = default;
+    PromiseOwner(const PromiseOwner&) = delete;
+    PromiseOwner& operator=(const PromiseOwner&) = delete;
+
+    ~PromiseOwner() {
+        state->complete([](SharedState<T>& s) {
+            s.error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+        });
+    }
+};
+
+// Result type of a continuation, with void mapped to Unit
+template <typename F, typename... Args>
+using ContinuationResult = std::conditional_t<std::is_void_v<std::invoke_result_t<F, Args...>>, Unit,
+                                              std::invoke_result_t<F, Args...>>;
+
+} // namespace detail
+
+template <typename T>
+class Promise {
+public:
+    Promise() : owner(std::make_shared<detail::PromiseOwner<T>>()) {}
+
+    Future<T> getFuture() const { return Future<T>(owner->state); }
+
+    void setValue(T value) {
+        owner->state->complete([&value](detail::SharedState<T>& s) { s.value.emplace(std::move(value)); });
+    }
+
+    void setException(std::exception_ptr error) {
+        owner->state->complete([&error](detail::SharedState<T>& s) { s.error = std::move(error); });
+    }
+
+    // Call f(args...) and store its result or exception
+    template <typename F, typename... Args>
+    void setWith(F&& f, Args&&... args) {
+        try {
+            if constexpr (std::is_void_v<std::invoke_result_t<F, Args...>>) {
+                std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+                setValue(Unit{});
+            } else {
+                setValue(std::invoke(std::forward<F>(f), std::forward<Args>(args)...));
+            }
+        } catch (...) {
+            setException(std::current_exception());
+        }
+    }
+
+private:
+    std::shared_ptr<detail::PromiseOwner<T>> owner;
+};
+
+template <typename T>
+class Future {
+public:
+    Future() = default;
+
+    bool valid() const { return state != nullptr; }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->ready;
+    }
+
+    // Blocking wait, meant for the edge of the program (e.g. main), never inside a continuation
+    void wait() const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->readyCondition.wait(lock, [this] { return state->ready; });
+    }
+
+    // Returns a copy, like std::shared_future: copies of this future and the continuations of then(), whenAll()
+    // and whenAny() read the same stored value, possibly at the same time, so it is never moved out
+    T get() const {
+        wait();
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        return *state->value;
+    }
+
+    // Low-level hook: call f() inline once this future is ready, with a value or an exception
+    // (used to resume a coroutine waiting on the future, see Coroutines.h)
+    template <typename F>
+    void onReady(F&& f) {
+        state->onReady(std::forward<F>(f));
+    }
+
+    // Schedule f(value) on the executor once this future is ready; returns a future for f's result.
+    // If this future failed, f is skipped and the exception is passed along.
+    template <typename Executor, typename F>
+    auto then(Executor& executor, F&& f) -> Future<detail::ContinuationResult<std::decay_t<F>, T&>> {
+        using Result = detail::ContinuationResult<std::decay_t<F>, T&>;
+        Promise<Result> next;
+        auto result = next.getFuture();
+        state->onReady([state = state, &executor, next, f = std::forward<F>(f)]() mutable {
+            executor.post([state, next, f = std::move(f)]() mutable {
+                if (state->error) {
+                    next.setException(state->error);
+                } else {
+                    next.setWith(std::move(f), *state->value); // Other continuations may read it too
+                }
+            });
+        });
+        return result;
+    }
+
+    // Continuation that runs inline on the thread completing this future
+    template <typename F>
+    auto then(F&& f) {
+        static InlineExecutor inlineExecutor;
+        return then(inlineExecutor, std::forward<F>(f));
+    }
+
+private:
+    template <typename>
+    friend class Promise;
+    template <typename U>
+    friend Future<std::vector<U>> whenAll(std::vector<Future<U>> futures);
+    template <typename U>
+    friend Future<std::pair<std::size_t, U>> whenAny(std::vector<Future<U>> futures);
+
+    explicit Future(std::shared_ptr<detail::SharedState<T>> state) : state(std::move(state)) {}
+
+    std::shared_ptr<detail::SharedState<T>> state;
+};
+
+template <typename T>
+Future<T> makeReadyFuture(T value) {
+    Promise<T> promise;
+    promise.setValue(std::move(value));
+    return promise.getFuture();
+}
+
+// Run f(args...) on the executor and return a continuable future for its result
+template <typename Executor, typename F, typename... Args>
+auto asyncOn(Executor& executor, F&& f, Args&&... args)
+    -> Future<detail::ContinuationResult<std::decay_t<F>, std::decay_t<Args>...>> {
+    using Result = detail::ContinuationResult<std::decay_t<F>, std::decay_t<Args>...>;
+    Promise<Result> promise;
+    auto future = promise.getFuture();
+    executor.post([promise, f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable {
+        promise.setWith(std::move(f), std::move(args)...);
+    });
+    return future;
+}
+
+// Ready when every input is ready; fails with the first exception. The last input to finish fulfils the result.
+template <typename T>
+Future<std::vector<T>> whenAll(std::vector<Future<T>> futures) {
+    if (futures.empty()) {
+        return makeReadyFuture(std::vector<T>{});
+    }
+    struct Context {
+        explicit Context(std::size_t count) : values(count), remaining(count) {}
+        std::vector<std::optional<T>> values;
+        std::atomic<std::size_t> remaining;
+        Promise<std::vector<T>> promise;
+    };
+    auto context = std::make_shared<Context>(futures.size());
+    auto result = context->promise.getFuture();
+
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        auto state = futures[i].state;
+        state->onReady([context, state, i] {
+            if (state->error) {
+                context->promise.setException(state->error); // Later completions are ignored
+            } else {
+                context->values[i].emplace(*state->value);
+            }
+            if (context->remaining.fetch_sub(1) == 1 && !state->error) {
+                std::vector<T> values;
+                values.reserve(context->values.size());
+                for (auto& value : context->values) {
+                    if (!value) {
+                        return; // Another input failed and already completed the promise
+                    }
+                    values.push_back(std::move(*value));
+                }
+                context->promise.setValue(std::move(values));
+            }
+        });
+    }
+    return result;
+}
+
+// Ready as soon as the first input is ready, with that input's index and value. Throws std::invalid_argument
+// for no inputs, which would never be ready.
+template <typename T>
+Future<std::pair<std::size_t, T>> whenAny(std::vector<Future<T>> futures) {
+    if (futures.empty()) {
+        throw std::invalid_argument("whenAny needs at least one future");
+    }
+    struct Context {
+        std::atomic<bool> done{false};
+        Promise<std::pair<std::size_t, T>> promise;
+    };
+    auto context = std::make_shared<Context>();
+    auto result = context->promise.getFuture();
+
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        auto state = futures[i].state;
+        state->onReady([context, state, i] {
+            if (context->done.exchange(true)) {
+                return; // Someone else won
+            }
+            if (state->error) {
+                context->promise.setException(state->error);
+            } else {
+                context->promise.setValue({i, *state->value});
+            }
+        });
+    }
+    return result;
+}
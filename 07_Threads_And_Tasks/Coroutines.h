@@ -0,0 +1,359 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "WorkStealingPool.h"
+#include "Continuations.h"
+
+// C++20 coroutine task type and scheduler.
+//
+// longRunningTask in tasks_example.cpp calls std::this_thread::sleep_for, which blocks a whole OS thread (with its
+// own stack of several MB of address space) for the entire wait. A coroutine can instead suspend: its local
+// variables live in a small heap-allocated frame, the thread goes back to the pool, and the scheduler resumes the
+// coroutine later. Waiting costs the frame (usually a few hundred bytes), not a thread.
+//
+//   Task<int> longRunningTask(Scheduler& scheduler, int input) {
+//       co_await scheduler.sleepFor(std::chrono::seconds(2)); // Suspends, no thread is blocked
+//       co_return input * 2;
+//   }
+//
+// - Task<T> is lazy: it starts when awaited (co_await task) or handed to Scheduler::spawn/blockOn.
+// - Scheduler resumes coroutines on a WorkStealingPool; with a one-thread pool it behaves like an event loop.
+// - co_await scheduler.sleepFor(d) parks the coroutine in the scheduler's timer queue.
+// - co_await scheduler.await(future) waits for a continuable Future (Continuations.h) without blocking.
+//
+// In C#, this is async/await: Task<T>, await Task.Delay(...) and the thread pool scheduler.
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+// Frame allocations are counted so the examples can report how much memory waiting coroutines really use.
+// noinline keeps GCC 12 from reporting a false -Wmismatched-new-delete on inlined coroutine frames.
+inline std::atomic<std::size_t> coroutineFrameBytes{0};
+inline std::atomic<std::size_t> coroutineFrameCount{0};
+
+struct CountedFrame {
+    [[gnu::noinline]] static void* operator new(std::size_t size) {
+        coroutineFrameBytes += size;
+        ++coroutineFrameCount;
+        return ::operator new(size);
+    }
+    [[gnu::noinline]] static void operator delete(void* frame, std::size_t size) {
+        coroutineFrameBytes -= size;
+        --coroutineFrameCount;
+        ::operator delete(frame, size);
+    }
+};
+
+// When a task finishes, jump straight to whoever awaited it (symmetric transfer, no stack growth)
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) const noexcept {
+        if (auto continuation = finished.promise().continuation) {
+            return continuation;
+        }
+        return std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase : CountedFrame {
+    std::suspend_always initial_suspend() const noexcept { return {}; } // Lazy start
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+};
+
+template <typename T>
+struct TaskPromise : PromiseBase {
+    Task<T> get_return_object();
+    void return_value(T v) { value.emplace(std::move(v)); }
+    T result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+    std::optional<T> value;
+};
+
+template <>
+struct TaskPromise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() const noexcept {}
+    void result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+} // namespace detail
+
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // co_await task: start it and resume the awaiting coroutine when it finishes
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle; // Symmetric transfer into the task
+            }
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{handle};
+    }
+
+private:
+    friend promise_type;
+    friend class Scheduler;
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Fire-and-forget coroutine used by Scheduler::spawn; destroys its own frame when done
+struct DetachedTask {
+    struct promise_type : CountedFrame {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Scheduler(WorkStealingPool& pool) : pool(pool), timerThread([this] { runTimers(); }) {}
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            stopping = true;
+        }
+        timerCondition.notify_one();
+        timerThread.join();
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Executor interface (see Continuations.h)
+    template <typename F>
+    void post(F&& f) {
+        pool.post(std::forward<F>(f));
+    }
+
+    void resumeOnPool(std::coroutine_handle<> handle) {
+        pool.post([handle] { handle.resume(); });
+    }
+
+    // co_await scheduler.schedule(): continue on a pool thread
+    auto schedule() {
+        struct Awaiter {
+            Scheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.resumeOnPool(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    struct SleepAwaiter {
+        Scheduler& scheduler;
+        Clock::time_point deadline;
+        bool await_ready() const noexcept { return deadline <= Clock::now(); }
+        void await_suspend(std::coroutine_handle<> handle) { scheduler.addTimer(deadline, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await scheduler.sleepFor(d): suspend without blocking a thread
+    SleepAwaiter sleepFor(Clock::duration delay) { return sleepUntil(Clock::now() + delay); }
+    SleepAwaiter sleepUntil(Clock::time_point deadline) { return SleepAwaiter{*this, deadline}; }
+
+    // co_await scheduler.await(future): resume on the pool once the continuable Future is ready
+    template <typename T>
+    auto await(Future<T> future) {
+        struct Awaiter {
+            Scheduler& scheduler;
+            Future<T> future;
+            bool await_ready() const { return future.isReady(); }
+            void await_suspend(std::coroutine_handle<> handle) {
+                // Runs inline on the completing thread, so it only re-posts the coroutine and never blocks
+                future.onReady([this, handle] { scheduler.resumeOnPool(handle); });
+            }
+            // Ready by now: returns a copy of the value (other holders of the future may read it too) or rethrows
+            T await_resume() const { return future.get(); }
+        };
+        return Awaiter{*this, std::move(future)};
+    }
+
+    // Start a task in the background; the scheduler keeps count until it finishes
+    void spawn(Task<void> task) {
+        ++running;
+        runDetached(std::move(task));
+    }
+
+    // Block the calling (non-pool) thread until every spawned task has finished, then rethrow the first exception
+    // a spawned task let escape, if any (the others are only counted, see failedSpawns)
+    void waitForSpawned() {
+        std::size_t value;
+        while ((value = running.load()) != 0) {
+            running.wait(value);
+        }
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(spawnErrorMutex);
+            error = std::exchange(spawnError, nullptr);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Number of spawned tasks that ended with an exception so far
+    std::size_t failedSpawns() const { return failed.load(std::memory_order_relaxed); }
+
+    // Run a task to completion from ordinary code such as main()
+    template <typename T>
+    T blockOn(Task<T> task) {
+        Promise<std::conditional_t<std::is_void_v<T>, Unit, T>> promise;
+        auto future = promise.getFuture();
+        deliver(std::move(task), promise);
+        return static_cast<T>(future.get());
+    }
+
+private:
+    template <typename T, typename P>
+    detail::DetachedTask deliver(Task<T> task, P promise) {
+        co_await schedule();
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+                promise.setValue(Unit{});
+            } else {
+                promise.setValue(co_await std::move(task));
+            }
+        } catch (...) {
+            promise.setException(std::current_exception());
+        }
+    }
+
+    // Nobody awaits a spawned task, so its exception is kept for waitForSpawned instead of reaching the worker
+    detail::DetachedTask runDetached(Task<void> task) {
+        co_await schedule();
+        try {
+            co_await std::move(task);
+        } catch (...) {
+            failed.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(spawnErrorMutex);
+            if (!spawnError) {
+                spawnError = std::current_exception();
+            }
+        }
+        if (running.fetch_sub(1) == 1) {
+            running.notify_all();
+        }
+    }
+
+    struct Timer {
+        Clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& other) const { return deadline > other.deadline; }
+    };
+
+    void addTimer(Clock::time_point deadline, std::coroutine_handle<> handle) {
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            timers.push({deadline, handle});
+            earliest = timers.top().handle == handle;
+        }
+        if (earliest) {
+            timerCondition.notify_one(); // The timer thread must wake up sooner than planned
+        }
+    }
+
+    // One thread owns all timers and hands due coroutines to the pool
+    void runTimers() {
+        std::unique_lock<std::mutex> lock(timerMutex);
+        while (!stopping) {
+            if (timers.empty()) {
+                timerCondition.wait(lock);
+                continue;
+            }
+            const auto next = timers.top().deadline;
+            if (Clock::now() < next) {
+                timerCondition.wait_until(lock, next);
+                continue;
+            }
+            while (!timers.empty() && timers.top().deadline <= Clock::now()) {
+                resumeOnPool(timers.top().handle);
+                timers.pop();
+            }
+        }
+    }
+
+    WorkStealingPool& pool;
+    std::atomic<std::size_t> running{0};
+    std::atomic<std::size_t> failed{0};
+    std::mutex spawnErrorMutex;
+    std::exception_ptr spawnError; // First exception from a spawned task, until waitForSpawned rethrows it
+
+    std::mutex timerMutex;
+    std::condition_variable timerCondition;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers;
+    bool stopping = false;
+    std::thread timerThread; // Declared last so it starts after the timer queue exists
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "WorkStealingPool.h"
+
+// parallelFor, parallelReduce and parallelInclusiveScan on a WorkStealingPool.
+//
+// A loop over a std::vector runs on one core. Splitting it into one piece per thread fails as soon as some
+// iterations are slower than others, or some threads are busy; splitting it into one task per element drowns the
+// work in scheduling overhead. These functions use lazy binary splitting (Tzannes et al., 2010):
+//
+// - The whole range starts as one task. A task works through its range grain iterations at a time.
+// - Before each chunk it checks its worker's deque. If the deque is empty, no other worker has anything to steal
+//   from it, so it splits the rest of its range in half and pushes the second half for a thief.
+// - If the deque is not empty, the other half would just sit there, so the task keeps going without splitting.
+//
+// The range is therefore only divided as finely as idle workers actually ask for. grain is the smallest piece of
+// work worth a task; 0 picks one from the range size and the number of workers.
+//
+// The caller blocks until the loop has finished (inside a worker it helps run tasks instead), and the first
+// exception thrown by the body is rethrown there.
+//
+// In C#, this is Parallel.For and PLINQ's Aggregate.
+
+namespace detail {
+
+// Completion counter shared with the loop's tasks: it must outlive the last one to call notify
+struct LoopState {
+    explicit LoopState(std::size_t iterations) : remaining(iterations) {}
+
+    void done(std::size_t iterations) {
+        if (remaining.fetch_sub(iterations) == iterations) {
+            remaining.notify_all();
+        }
+    }
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+            error = std::move(e);
+            failed.store(true);
+        }
+    }
+
+    void wait(WorkStealingPool& pool) {
+        std::size_t left;
+        while ((left = remaining.load()) != 0) {
+            if (pool.currentWorkerIndex() < 0) {
+                remaining.wait(left);
+            } else if (!pool.tryRunPendingTask()) {
+                std::this_thread::yield(); // Inside a worker: help instead of blocking it
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::atomic<std::size_t> remaining;
+    std::atomic<bool> failed{false};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+inline std::size_t autoGrain(const WorkStealingPool& pool, std::size_t iterations) {
+    // About 16 chunks per worker: enough to balance uneven work, few enough to keep the overhead invisible
+    return std::max<std::size_t>(1, iterations / (std::size_t{pool.size()} * 16));
+}
+
+// Runs chunk(begin, end) over [begin, end), splitting lazily as described above
+template <typename Chunk>
+void splitAndRun(WorkStealingPool& pool, const std::shared_ptr<LoopState>& state, Chunk& chunk, std::size_t begin,
+                 std::size_t end, std::size_t grain) {
+    std::size_t processed = 0; // The halves given away report their own iterations
+    while (begin < end) {
+        if (end - begin >= 2 * grain && pool.localQueueEmpty()) {
+            const std::size_t middle = begin + (end - begin) / 2;
+            pool.post([&pool, state, &chunk, middle, end, grain] {
+                splitAndRun(pool, state, chunk, middle, end, grain);
+            });
+            end = middle;
+            continue;
+        }
+        const std::size_t chunkEnd = std::min(begin + grain, end);
+        if (!state->failed.load(std::memory_order_relaxed)) {
+            try {
+                chunk(begin, chunkEnd);
+            } catch (...) {
+                state->fail(std::current_exception());
+            }
+        }
+        processed += chunkEnd - begin;
+        begin = chunkEnd;
+    }
+    state->done(processed);
+}
+
+// Run chunk(begin, end) over [first, last) on the pool and wait
+template <typename Chunk>
+void forEachChunk(WorkStealingPool& pool, std::size_t first, std::size_t last, std::size_t grain, Chunk& chunk) {
+    if (first >= last) {
+        return;
+    }
+    const std::size_t iterations = last - first;
+    if (grain == 0) {
+        grain = autoGrain(pool, iterations);
+    }
+    auto state = std::make_shared<LoopState>(iterations);
+    pool.post([&pool, state, &chunk, first, last, grain] { splitAndRun(pool, state, chunk, first, last, grain); });
+    state->wait(pool);
+}
+
+} // namespace detail
+
+// Call body(i) for every i in [first, last), or body(begin, end) for whole chunks if the body takes two indices
+template <typename Body>
+void parallelFor(WorkStealingPool& pool, std::size_t first, std::size_t last, Body&& body, std::size_t grain = 0) {
+    if constexpr (std::is_invocable_v<Body&, std::size_t, std::size_t>) {
+        detail::forEachChunk(pool, first, last, grain, body);
+    } else {
+        auto chunk = [&body](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                body(i);
+            }
+        };
+        detail::forEachChunk(pool, first, last, grain, chunk);
+    }
+}
+
+// combine(... combine(combine(identity, map(first)), map(first + 1)) ..., map(last - 1)).
+// Each worker folds its chunks into its own slot and the slots are combined at the end, so combine must be
+// associative and commutative (for floating point the rounding may differ from run to run).
+template <typename T, typename Map, typename Combine>
+T parallelReduce(WorkStealingPool& pool, std::size_t first, std::size_t last, T identity, Map&& map,
+                 Combine&& combine, std::size_t grain = 0) {
+    struct alignas(64) Slot {
+        T value;
+    };
+    std::vector<Slot> slots(pool.size(), Slot{identity});
+    auto chunk = [&](std::size_t begin, std::size_t end) {
+        T local = identity;
+        for (std::size_t i = begin; i < end; ++i) {
+            local = combine(std::move(local), map(i));
+        }
+        T& slot = slots[static_cast<std::size_t>(pool.currentWorkerIndex())].value; // Only this worker writes it
+        slot = combine(std::move(slot), std::move(local));
+    };
+    detail::forEachChunk(pool, first, last, grain, chunk);
+
+    T result = std::move(identity);
+    for (Slot& slot : slots) {
+        result = combine(std::move(result), std::move(slot.value));
+    }
+    return result;
+}
+
+// Like std::inclusive_scan with an initial identity: out[i] = in[first] combine ... combine in[i].
+// Two passes over blocks: sum every block in parallel, scan the block sums, then scan every block again in parallel
+// starting from its offset. combine must be associative.
+template <typename InputIt, typename OutputIt, typename T, typename Combine>
+OutputIt parallelInclusiveScan(WorkStealingPool& pool, InputIt first, InputIt last, OutputIt out, T identity,
+                               Combine&& combine, std::size_t grain = 0) {
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    if (count == 0) {
+        return out;
+    }
+    const std::size_t blockSize = grain != 0 ? grain : std::max<std::size_t>(4096, count / (pool.size() * 8));
+    const std::size_t blocks = (count + blockSize - 1) / blockSize;
+
+    std::vector<T> offsets(blocks, identity);
+    parallelFor(pool, 0, blocks, [&](std::size_t block) {
+        const std::size_t end = std::min(count, (block + 1) * blockSize);
+        T sum = identity;
+        for (std::size_t i = block * blockSize; i < end; ++i) {
+            sum = combine(std::move(sum), first[static_cast<std::ptrdiff_t>(i)]);
+        }
+        offsets[block] = std::move(sum);
+    }, 1);
+
+    T running = identity; // Turn block sums into the value before each block
+    for (T& offset : offsets) {
+        T sum = std::move(offset);
+        offset = running;
+        running = combine(std::move(running), std::move(sum));
+    }
+
+    parallelFor(pool, 0, blocks, [&](std::size_t block) {
+        const std::size_t end = std::min(count, (block + 1) * blockSize);
+        T value = offsets[block];
+        for (std::size_t i = block * blockSize; i < end; ++i) {
+            value = combine(std::move(value), first[static_cast<std::ptrdiff_t>(i)]);
+            out[static_cast<std::ptrdiff_t>(i)] = value;
+        }
+    }, 1);
+    return out + static_cast<std::ptrdiff_t>(count);
+}
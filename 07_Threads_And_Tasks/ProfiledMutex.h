@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Lock contention profiler.
+//
+// A std::mutex gives no hint of how much time threads spend waiting for it. ProfiledMutex is a drop-in replacement
+// (it works with std::lock_guard, std::unique_lock and std::condition_variable_any) that records, per lock name:
+//
+// - acquisitions, and how many of them were contended (the lock was already taken)
+// - wait time: how long lock() blocked
+// - hold time: how long the lock was held before unlock()
+//
+// Locks with the same name share their statistics, e.g. the mutex of every Event instance. Contention is counted
+// exactly, because it is found on the slow path anyway (try_lock failed). Timing costs two clock reads per
+// acquisition, so with setSampleRate(n) only every n-th acquisition on each thread is timed and the totals are
+// scaled up: estimates instead of exact numbers, for a fraction of the overhead.
+//
+// LockProfiler::instance().report(std::cout) lists the hottest locks (by total wait time); with reportAtExit(true)
+// the report is printed to std::cerr when the program ends.
+//
+// In C#, this is what the "lock contention" events of dotnet-counters/PerfView show for Monitor.
+
+class LockProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct LockStats {
+        explicit LockStats(std::string name) : name(std::move(name)) {}
+
+        void recordWait(std::int64_t ns) {
+            sampledWaits.fetch_add(1, std::memory_order_relaxed);
+            totalWaitNs.fetch_add(ns, std::memory_order_relaxed);
+            raiseMax(maxWaitNs, ns);
+        }
+
+        void recordHold(std::int64_t ns) {
+            sampledHolds.fetch_add(1, std::memory_order_relaxed);
+            totalHoldNs.fetch_add(ns, std::memory_order_relaxed);
+            raiseMax(maxHoldNs, ns);
+        }
+
+        const std::string name;
+        std::atomic<std::uint64_t> acquisitions{0}; // Estimate: each timed acquisition counts for the sample rate
+        std::atomic<std::uint64_t> contended{0};    // Exact
+        std::atomic<std::uint64_t> sampledWaits{0}; // Contended acquisitions that were timed
+        std::atomic<std::uint64_t> sampledHolds{0};
+        std::atomic<std::int64_t> totalWaitNs{0};
+        std::atomic<std::int64_t> maxWaitNs{0};
+        std::atomic<std::int64_t> totalHoldNs{0};
+        std::atomic<std::int64_t> maxHoldNs{0};
+
+    private:
+        static void raiseMax(std::atomic<std::int64_t>& maximum, std::int64_t value) {
+            std::int64_t current = maximum.load(std::memory_order_relaxed);
+            while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+    };
+
+    static LockProfiler& instance() {
+        static LockProfiler profiler;
+        return profiler;
+    }
+
+    // Statistics for a lock name, created on first use; the reference stays valid for the life of the program
+    LockStats& statsFor(const std::string& name) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto& stats = locks[name];
+        if (!stats) {
+            stats = std::make_unique<LockStats>(name);
+        }
+        return *stats;
+    }
+
+    // Time one acquisition in every n on each thread (1 = all of them)
+    void setSampleRate(std::uint32_t n) { sampleRate.store(std::max<std::uint32_t>(n, 1)); }
+    std::uint32_t getSampleRate() const { return sampleRate.load(std::memory_order_relaxed); }
+
+    void reportAtExit(bool enabled) { printAtExit = enabled; }
+
+    void report(std::ostream& out, std::size_t top = 10) {
+        std::vector<const LockStats*> sorted;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (const auto& [name, stats] : locks) {
+                sorted.push_back(stats.get());
+            }
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const LockStats* a, const LockStats* b) {
+            return estimatedWaitNs(*a) > estimatedWaitNs(*b);
+        });
+
+        out << "Lock contention report, hottest first:\n";
+        out << std::left << std::setw(24) << "lock" << std::right << std::setw(12) << "acquires" << std::setw(11)
+            << "contended" << std::setw(14) << "wait total" << std::setw(12) << "wait max" << std::setw(12)
+            << "hold avg" << std::setw(12) << "hold max" << "\n";
+        for (std::size_t i = 0; i < sorted.size() && i < top; ++i) {
+            const LockStats& s = *sorted[i];
+            const auto acquisitions = static_cast<double>(s.acquisitions.load());
+            const double contendedPercent =
+                acquisitions > 0 ? 100.0 * static_cast<double>(s.contended.load()) / acquisitions : 0.0;
+            const auto holds = s.sampledHolds.load();
+            out << std::left << std::setw(24) << s.name << std::right << std::setw(12)
+                << static_cast<std::uint64_t>(acquisitions) << std::setw(10) << std::fixed << std::setprecision(1)
+                << std::min(contendedPercent, 100.0) << "%" << std::setw(14) << formatNs(estimatedWaitNs(s))
+                << std::setw(12) << formatNs(static_cast<double>(s.maxWaitNs.load())) << std::setw(12)
+                << formatNs(holds ? static_cast<double>(s.totalHoldNs.load()) / static_cast<double>(holds) : 0.0)
+                << std::setw(12) << formatNs(static_cast<double>(s.maxHoldNs.load())) << "\n";
+        }
+    }
+
+private:
+    LockProfiler() = default;
+
+    ~LockProfiler() {
+        if (printAtExit) {
+            report(std::cerr);
+        }
+    }
+
+    // Timed waits scaled up to every contended acquisition
+    static double estimatedWaitNs(const LockStats& s) {
+        const auto timed = s.sampledWaits.load();
+        if (timed == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(s.totalWaitNs.load()) * static_cast<double>(s.contended.load()) /
+               static_cast<double>(timed);
+    }
+
+    static std::string formatNs(double ns) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1);
+        if (ns >= 1e9) {
+            text << ns / 1e9 << " s";
+        } else if (ns >= 1e6) {
+            text << ns / 1e6 << " ms";
+        } else if (ns >= 1e3) {
+            text << ns / 1e3 << " us";
+        } else {
+            text << ns << " ns";
+        }
+        return text.str();
+    }
+
+    std::mutex registryMutex;
+    std::map<std::string, std::unique_ptr<LockStats>> locks;
+    std::atomic<std::uint32_t> sampleRate{1};
+    bool printAtExit = false;
+};
+
+class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const std::string& name) : stats(LockProfiler::instance().statsFor(name)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        const std::uint32_t weight = sampleWeight();
+        if (mutex.try_lock()) {
+            acquired(weight); // Fast path: no contention, nothing to wait for
+            return;
+        }
+        stats.contended.fetch_add(1, std::memory_order_relaxed);
+        if (weight == 0) {
+            mutex.lock();
+            return;
+        }
+        const auto start = LockProfiler::Clock::now();
+        mutex.lock();
+        const auto now = LockProfiler::Clock::now();
+        stats.recordWait(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+        stats.acquisitions.fetch_add(weight, std::memory_order_relaxed);
+        holdStart = now;
+        holdTimed = true;
+    }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) {
+            return false;
+        }
+        acquired(sampleWeight());
+        return true;
+    }
+
+    void unlock() {
+        if (holdTimed) {
+            holdTimed = false;
+            stats.recordHold(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(LockProfiler::Clock::now() - holdStart).count());
+        }
+        mutex.unlock();
+    }
+
+private:
+    // 0 if this acquisition is not timed, otherwise how many acquisitions it stands for. A per-thread countdown
+    // means sampling needs no shared counter.
+    static std::uint32_t sampleWeight() {
+        thread_local std::uint32_t countdown = 0;
+        thread_local std::uint32_t rate = 1;
+        if (countdown == 0) {
+            rate = LockProfiler::instance().getSampleRate();
+            countdown = rate;
+        }
+        return --countdown == 0 ? rate : 0;
+    }
+
+    // Called with the lock held, so holdStart/holdTimed need no synchronization of their own
+    void acquired(std::uint32_t weight) {
+        if (weight != 0) {
+            stats.acquisitions.fetch_add(weight, std::memory_order_relaxed);
+            holdStart = LockProfiler::Clock::now();
+            holdTimed = true;
+        }
+    }
+
+    std::mutex mutex;
+    LockProfiler::LockStats& stats;
+    LockProfiler::Clock::time_point holdStart;
+    bool holdTimed = false;
+};
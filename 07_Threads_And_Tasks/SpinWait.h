@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+
+// Helpers for "spin briefly, then park" waiting.
+//
+// Putting a thread to sleep and waking it again costs a system call on each side (a few microseconds). When the
+// thing we wait for usually happens within a few hundred nanoseconds (a short critical section, a queue slot being
+// filled), it is cheaper to spin for a moment first. Spinning forever burns a core the other thread may need, so
+// the spin is bounded and the caller parks (std::atomic::wait, a futex on Linux) once the budget is spent.
+//
+// In C#, this is System.Threading.SpinWait.
+
+// Tells the CPU we are in a spin loop: saves power and frees the core for a hyper-threaded sibling
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Bounded exponential backoff: each round pauses twice as long as the previous one, up to maxRounds rounds
+class SpinWait {
+public:
+    explicit SpinWait(int maxRounds = 7) : maxRounds(maxRounds) {}
+
+    // Spin one round; returns false once the budget is spent and the caller should park instead
+    bool spinOnce() {
+        if (round >= maxRounds) {
+            return false;
+        }
+        if (singleCore()) {
+            std::this_thread::yield(); // Spinning cannot help: the thread we wait for needs this core
+        } else {
+            const int pauses = 1 << std::min(round, 10);
+            for (int i = 0; i < pauses; ++i) {
+                cpuRelax();
+            }
+        }
+        ++round;
+        return true;
+    }
+
+    void reset() { round = 0; }
+
+private:
+    static bool singleCore() {
+        static const bool single = std::thread::hardware_concurrency() == 1;
+        return single;
+    }
+
+    int maxRounds;
+    int round = 0;
+};
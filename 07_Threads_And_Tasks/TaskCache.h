@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+// Memoizing cache for deferred computations.
+//
+// std::async(std::launch::deferred, longRunningTask, 5) runs longRunningTask again every time it is asked for, even
+// if the answer for 5 was computed a moment ago. TaskCache remembers the results by key:
+//
+// - get(key, compute) returns a std::shared_future. The first caller for a key stores a deferred future of
+//   compute(); later callers get a copy of the same future.
+// - Single flight: a deferred future runs its function once, in the first thread that waits on it, and every other
+//   thread waiting on it blocks until that run is done. Concurrent callers for one key share one computation
+//   instead of racing to compute it N times.
+// - Eviction: least recently used entries go first once there are more than maxEntries, or once the total cost of
+//   the finished results (e.g. their size in bytes) is above maxCost. Evicting an entry never cancels it: callers
+//   that already hold the future still get the result.
+// - A computation that throws is not cached; its callers get the exception, the next caller tries again.
+// - stats() reports hits, misses, how many hits joined an unfinished computation, and evictions.
+//
+// Memoized<R(Args...)> wraps a function so that calling it looks up the cache with its arguments as the key.
+//
+// In C#, this is a ConcurrentDictionary<TKey, Lazy<Task<TValue>>> in front of MemoryCache.
+
+struct TaskCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;      // Computations started
+    std::uint64_t joinedHits = 0;  // Hits on a computation that had not finished yet
+    std::uint64_t evictions = 0;
+    std::uint64_t failures = 0;    // Computations that threw and were removed
+
+    double hitRate() const {
+        const auto lookups = hits + misses;
+        return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class TaskCache {
+public:
+    using CostFunction = std::function<std::size_t(const Value&)>;
+
+    explicit TaskCache(std::size_t maxEntries, std::size_t maxCost = std::numeric_limits<std::size_t>::max(),
+                       CostFunction costOf = [](const Value&) { return std::size_t{1}; })
+        : state(std::make_shared<State>()) {
+        state->maxEntries = maxEntries;
+        state->maxCost = maxCost;
+        state->costOf = std::move(costOf);
+    }
+
+    // The cached future for key, or a new deferred future of compute() if there is none
+    template <typename F>
+    std::shared_future<Value> get(const Key& key, F&& compute) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (auto found = state->index.find(key); found != state->index.end()) {
+            state->lru.splice(state->lru.begin(), state->lru, found->second); // Most recently used goes first
+            ++state->stats.hits;
+            if (!found->second->ready) {
+                ++state->stats.joinedHits;
+            }
+            return found->second->future;
+        }
+
+        ++state->stats.misses;
+        const std::uint64_t id = ++state->nextId;
+        // The deferred function reports back to the cache through a weak pointer: the cache may be gone by the
+        // time somebody finally waits on the future
+        std::weak_ptr<State> weakState = state;
+        std::shared_future<Value> future =
+            std::async(std::launch::deferred, [weakState, key, id, compute = std::forward<F>(compute)]() mutable {
+                try {
+                    Value value = compute();
+                    if (auto alive = weakState.lock()) {
+                        alive->settle(key, id, value);
+                    }
+                    return value;
+                } catch (...) {
+                    if (auto alive = weakState.lock()) {
+                        alive->forget(key, id);
+                    }
+                    throw;
+                }
+            }).share();
+        state->lru.push_front(Entry{key, future, id, 0, false});
+        state->index.emplace(key, state->lru.begin());
+        state->evictOverLimits();
+        return future;
+    }
+
+    // Drop the entry for key, if any; the next get() computes it again
+    void invalidate(const Key& key) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (auto found = state->index.find(key); found != state->index.end()) {
+            state->erase(found->second);
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->index.clear();
+        state->lru.clear();
+        state->totalCost = 0;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->lru.size();
+    }
+
+    // Total cost of the finished results in the cache
+    std::size_t cost() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->totalCost;
+    }
+
+    TaskCacheStats stats() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->stats;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        std::shared_future<Value> future;
+        std::uint64_t id; // Tells a re-inserted key apart from the entry that was evicted before it
+        std::size_t cost;
+        bool ready;
+    };
+
+    using Iterator = typename std::list<Entry>::iterator;
+
+    struct State {
+        // Called by the computing thread once the value exists
+        void settle(const Key& key, std::uint64_t id, const Value& value) {
+            const std::size_t valueCost = costOf(value);
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(key);
+            if (found == index.end() || found->second->id != id) {
+                return; // Evicted while it was computing
+            }
+            found->second->ready = true;
+            found->second->cost = valueCost;
+            totalCost += valueCost;
+            evictOverLimits();
+        }
+
+        void forget(const Key& key, std::uint64_t id) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.failures;
+            auto found = index.find(key);
+            if (found != index.end() && found->second->id == id) {
+                erase(found->second);
+            }
+        }
+
+        // From the least recently used end; the newest entry always stays, even if it alone is over maxCost
+        void evictOverLimits() {
+            while (lru.size() > 1 && (lru.size() > maxEntries || totalCost > maxCost)) {
+                erase(std::prev(lru.end()));
+                ++stats.evictions;
+            }
+        }
+
+        void erase(Iterator entry) {
+            totalCost -= entry->cost;
+            index.erase(entry->key);
+            lru.erase(entry);
+        }
+
+        mutable std::mutex mutex;
+        std::list<Entry> lru; // Most recently used first
+        std::unordered_map<Key, Iterator, Hash> index;
+        std::size_t maxEntries = 0;
+        std::size_t maxCost = 0;
+        std::size_t totalCost = 0;
+        CostFunction costOf;
+        std::uint64_t nextId = 0;
+        TaskCacheStats stats;
+    };
+
+    std::shared_ptr<State> state;
+};
+
+// Hash for std::tuple keys, combining the std::hash of every element
+struct TupleHash {
+    template <typename... Ts>
+    std::size_t operator()(const std::tuple<Ts...>& key) const {
+        std::size_t seed = 0;
+        std::apply([&seed](const auto&... parts) {
+            ((seed ^= std::hash<std::decay_t<decltype(parts)>>{}(parts) + 0x9E3779B97F4A7C15ull + (seed << 6) +
+                      (seed >> 2)),
+             ...);
+        }, key);
+        return seed;
+    }
+};
+
+template <typename Signature>
+class Memoized;
+
+// A function whose results are cached by argument values, e.g. Memoized<int(int)> cached(longRunningTask, 100)
+template <typename R, typename... Args>
+class Memoized<R(Args...)> {
+public:
+    using Key = std::tuple<std::decay_t<Args>...>;
+
+    template <typename F>
+    Memoized(F f, std::size_t maxEntries, std::size_t maxCost = std::numeric_limits<std::size_t>::max(),
+             typename TaskCache<Key, R, TupleHash>::CostFunction costOf = [](const R&) { return std::size_t{1}; })
+        : function(std::make_shared<std::function<R(Args...)>>(std::move(f))),
+          cache(maxEntries, maxCost, std::move(costOf)) {}
+
+    std::shared_future<R> operator()(Args... args) {
+        Key key(args...);
+        return cache.get(key, [function = function, key] { return std::apply(*function, key); });
+    }
+
+    TaskCache<Key, R, TupleHash>& underlyingCache() { return cache; }
+
+private:
+    std::shared_ptr<std::function<R(Args...)>> function; // Shared with the pending computations, which may outlive us
+    TaskCache<Key, R, TupleHash> cache;
+};
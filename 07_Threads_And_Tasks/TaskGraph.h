@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "WorkStealingPool.h"
+
+// Task graph (DAG) executor.
+//
+// A multi-stage job is rarely a straight line: "fetch A" and "fetch B" can run together, "merge" needs both, and
+// "report" needs "merge". Waiting for a whole stage with a barrier wastes workers whenever one task of the stage is
+// slow. A task graph states the real dependencies instead:
+//
+//   TaskGraph graph;
+//   auto a = graph.add("fetch A", fetchA);
+//   auto b = graph.add("fetch B", fetchB);
+//   auto merge = graph.add("merge", mergeResults);
+//   graph.precede(a, merge);
+//   graph.precede(b, merge);
+//   TaskGraphExecutor(pool).run(graph);
+//
+// - Every node keeps an atomic count of unfinished predecessors. The predecessor that brings it to zero makes the
+//   node ready, so no thread ever waits for a dependency.
+// - Ready nodes are handed out critical-path-first: a node's rank is its cost plus the largest rank among its
+//   successors, and the ready node with the highest rank runs next. Long chains start early instead of being left
+//   for the end. Order::Fifo runs nodes in the order they became ready, for comparison.
+// - addDynamic() nodes build a subgraph while they run (e.g. split work once its size is known). The node counts as
+//   finished, and releases its successors, only when its whole subgraph has finished.
+// - run() returns a GraphTrace (which worker ran which node, and when) that can be written as a Chrome trace
+//   (chrome://tracing or ui.perfetto.dev); writeDot() writes the graph itself for Graphviz.
+//
+// In C#, this is TPL Dataflow or Task.WhenAll/ContinueWith chains built by hand.
+
+class TaskGraph {
+public:
+    using TaskId = std::size_t;
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // cost is an estimate in any unit (e.g. microseconds); only its relative size matters for scheduling
+    TaskId add(std::string name, std::function<void()> work, double cost = 1.0) {
+        Node& node = nodes.emplace_back(std::move(name), cost, nodes.size());
+        node.work = std::move(work);
+        return nodes.size() - 1;
+    }
+
+    // The callback receives an empty subgraph to fill; the executor runs it before releasing this node's successors
+    TaskId addDynamic(std::string name, std::function<void(TaskGraph&)> build, double cost = 1.0) {
+        Node& node = nodes.emplace_back(std::move(name), cost, nodes.size());
+        node.build = std::move(build);
+        return nodes.size() - 1;
+    }
+
+    // before must finish before after starts
+    void precede(TaskId before, TaskId after) {
+        nodes.at(before).successors.push_back(&nodes.at(after));
+        ++nodes[after].predecessorCount;
+    }
+
+    std::size_t size() const { return nodes.size(); }
+
+    // Length of the longest chain of costs; throws std::invalid_argument if the graph has a cycle
+    double criticalPath() {
+        computeRanks();
+        double longest = 0;
+        for (const Node& node : nodes) {
+            longest = std::max(longest, node.rank);
+        }
+        return longest;
+    }
+
+    // Graphviz: dot -Tsvg graph.dot > graph.svg
+    void writeDot(std::ostream& out) const {
+        out << "digraph TaskGraph {\n";
+        writeDotNodes(out, "n");
+        out << "}\n";
+    }
+
+private:
+    friend class TaskGraphExecutor;
+    friend struct GraphTrace;
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        Node(std::string name, double cost, std::size_t index) : name(std::move(name)), cost(cost), index(index) {}
+
+        std::string name;
+        double cost;
+        std::size_t index; // Position in the owning graph
+        std::function<void()> work;
+        std::function<void(TaskGraph&)> build;
+        std::vector<Node*> successors;
+        int predecessorCount = 0;
+        double rank = 0;
+
+        // Per run
+        std::atomic<int> remaining{0};
+        std::atomic<std::size_t> pendingChildren{0}; // Subgraph nodes plus one for the node itself
+        Node* parent = nullptr;
+        std::unique_ptr<TaskGraph> subgraph;
+        int worker = -1;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    // Kahn's algorithm for a topological order, then ranks from the sinks back to the roots
+    void computeRanks() {
+        std::vector<Node*> order;
+        order.reserve(nodes.size());
+        std::vector<int> inDegree;
+        inDegree.reserve(nodes.size());
+        for (Node& node : nodes) {
+            inDegree.push_back(node.predecessorCount);
+            if (node.predecessorCount == 0) {
+                order.push_back(&node);
+            }
+        }
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            for (Node* successor : order[i]->successors) {
+                if (--inDegree[successor->index] == 0) {
+                    order.push_back(successor);
+                }
+            }
+        }
+        if (order.size() != nodes.size()) {
+            throw std::invalid_argument("TaskGraph contains a cycle");
+        }
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            double longestAfter = 0;
+            for (Node* successor : (*it)->successors) {
+                longestAfter = std::max(longestAfter, successor->rank);
+            }
+            (*it)->rank = (*it)->cost + longestAfter;
+        }
+    }
+
+    void writeDotNodes(std::ostream& out, const std::string& prefix) const {
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            const Node& node = nodes[i];
+            const std::string id = prefix + std::to_string(i);
+            out << "  " << id << " [label=\"" << node.name << "\"" << (node.build ? " shape=box" : "") << "];\n";
+            for (const Node* successor : node.successors) {
+                out << "  " << id << " -> " << prefix << successor->index << ";\n";
+            }
+            if (node.subgraph) {
+                // Subgraph from the last run, drawn as a cluster hanging off its parent
+                out << "  subgraph cluster_" << id << " {\n  label=\"" << node.name << "\";\n";
+                node.subgraph->writeDotNodes(out, id + "_");
+                out << "  }\n";
+                for (std::size_t c = 0; c < node.subgraph->nodes.size(); ++c) {
+                    if (node.subgraph->nodes[c].predecessorCount == 0) {
+                        out << "  " << id << " -> " << id << "_" << c << " [style=dashed];\n";
+                    }
+                }
+            }
+        }
+    }
+
+    std::deque<Node> nodes; // Stable addresses: successors point straight at nodes
+};
+
+// What happened during one run of a graph
+struct GraphTrace {
+    struct Event {
+        std::string name;
+        int worker;
+        double startUs;
+        double durationUs;
+    };
+
+    std::vector<Event> events;
+    double makespanUs = 0;
+
+    // Chrome trace event format: one "complete" event per node, one row per worker
+    void writeChromeTrace(std::ostream& out) const {
+        out << "{\"traceEvents\":[\n";
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const Event& e = events[i];
+            out << "  {\"name\":\"" << escaped(e.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.worker
+                << ",\"ts\":" << e.startUs << ",\"dur\":" << e.durationUs << "}" << (i + 1 < events.size() ? "," : "")
+                << "\n";
+        }
+        out << "]}\n";
+    }
+
+private:
+    friend class TaskGraphExecutor;
+
+    void collect(const TaskGraph& graph, TaskGraph::Clock::time_point origin, const std::string& prefix) {
+        for (const auto& node : graph.nodes) {
+            events.push_back({prefix + node.name, node.worker,
+                              std::chrono::duration<double, std::micro>(node.start - origin).count(),
+                              std::chrono::duration<double, std::micro>(node.end - node.start).count()});
+            if (node.subgraph) {
+                collect(*node.subgraph, origin, prefix + node.name + "/");
+            }
+        }
+    }
+
+    static std::string escaped(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    }
+};
+
+class TaskGraphExecutor {
+public:
+    enum class Order { CriticalPathFirst, Fifo };
+
+    explicit TaskGraphExecutor(WorkStealingPool& pool, Order order = Order::CriticalPathFirst)
+        : pool(pool), order(order) {}
+
+    // Run every node once and wait for the whole graph. Rethrows the first exception thrown by a node; once a
+    // node has failed, the nodes that have not started yet are skipped.
+    GraphTrace run(TaskGraph& graph) {
+        graph.computeRanks();
+        auto state = std::make_shared<RunState>(pool, order);
+        for (auto& node : graph.nodes) {
+            node.remaining.store(node.predecessorCount, std::memory_order_relaxed);
+            node.parent = nullptr;
+            node.subgraph.reset();
+        }
+        state->outstanding.store(graph.nodes.size());
+        const auto start = TaskGraph::Clock::now();
+        for (auto& node : graph.nodes) {
+            if (node.predecessorCount == 0) {
+                RunState::makeReady(state, &node);
+            }
+        }
+
+        std::size_t left;
+        while ((left = state->outstanding.load()) != 0) {
+            if (pool.currentWorkerIndex() < 0) {
+                state->outstanding.wait(left);
+            } else if (!pool.tryRunPendingTask()) {
+                std::this_thread::yield(); // Inside a worker: help instead of blocking it (see tryRunPendingTask)
+            }
+        }
+
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        GraphTrace trace;
+        trace.makespanUs = std::chrono::duration<double, std::micro>(TaskGraph::Clock::now() - start).count();
+        trace.collect(graph, start, "");
+        return trace;
+    }
+
+private:
+    using Node = TaskGraph::Node;
+
+    // Shared with every posted task so it outlives the last notify
+    struct RunState {
+        RunState(WorkStealingPool& pool, Order order) : pool(pool), order(order) {}
+
+        struct Ready {
+            double priority;
+            std::uint64_t sequence;
+            Node* node;
+            bool operator<(const Ready& other) const {
+                return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+            }
+        };
+
+        // Every ready node posts one pool task; that task runs whichever ready node has the highest priority then
+        static void makeReady(const std::shared_ptr<RunState>& state, Node* node) {
+            {
+                std::lock_guard<std::mutex> lock(state->readyMutex);
+                const std::uint64_t sequence = state->sequence++;
+                state->ready.push({state->order == Order::CriticalPathFirst ? node->rank : 0.0, sequence, node});
+            }
+            state->pool.post([state] { state->runNext(state); });
+        }
+
+        void runNext(const std::shared_ptr<RunState>& self) {
+            Node* node;
+            {
+                std::lock_guard<std::mutex> lock(readyMutex);
+                node = ready.top().node;
+                ready.pop();
+            }
+            execute(self, node);
+        }
+
+        void execute(const std::shared_ptr<RunState>& self, Node* node) {
+            node->worker = pool.currentWorkerIndex();
+            node->start = TaskGraph::Clock::now();
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    if (node->build) {
+                        node->subgraph = std::make_unique<TaskGraph>();
+                        node->build(*node->subgraph);
+                        node->subgraph->computeRanks();
+                    } else if (node->work) {
+                        node->work();
+                    }
+                } catch (...) {
+                    fail(std::current_exception());
+                    node->subgraph.reset();
+                }
+            }
+            node->end = TaskGraph::Clock::now();
+
+            if (!node->subgraph || node->subgraph->nodes.empty()) {
+                finish(self, node);
+                return;
+            }
+            TaskGraph& subgraph = *node->subgraph;
+            const double rankOffset = node->rank - node->cost; // Children inherit the chain that follows the parent
+            for (auto& child : subgraph.nodes) {
+                child.remaining.store(child.predecessorCount, std::memory_order_relaxed);
+                child.parent = node;
+                child.rank += rankOffset;
+            }
+            node->pendingChildren.store(subgraph.nodes.size() + 1);
+            outstanding.fetch_add(subgraph.nodes.size());
+            for (auto& child : subgraph.nodes) {
+                if (child.predecessorCount == 0) {
+                    makeReady(self, &child);
+                }
+            }
+            if (node->pendingChildren.fetch_sub(1) == 1) {
+                finish(self, node);
+            }
+        }
+
+        // The node and its whole subgraph are done: release successors, then the parent, then the run
+        void finish(const std::shared_ptr<RunState>& self, Node* node) {
+            for (Node* successor : node->successors) {
+                if (successor->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    makeReady(self, successor);
+                }
+            }
+            if (node->parent && node->parent->pendingChildren.fetch_sub(1) == 1) {
+                finish(self, node->parent);
+            }
+            if (outstanding.fetch_sub(1) == 1) {
+                outstanding.notify_all();
+            }
+        }
+
+        void fail(std::exception_ptr e) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::move(e);
+                failed.store(true);
+            }
+        }
+
+        WorkStealingPool& pool;
+        const Order order;
+
+        std::mutex readyMutex;
+        std::priority_queue<Ready> ready;
+        std::uint64_t sequence = 0;
+
+        std::atomic<std::size_t> outstanding{0}; // Nodes not finished yet, subgraph nodes included
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        std::atomic<bool> failed{false};
+    };
+
+    WorkStealingPool& pool;
+    Order order;
+};
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Hashed hierarchical timer wheel (Varghese & Lauck), the structure the Linux kernel uses for its timers.
+//
+// A priority queue of deadlines costs O(log n) per insert and cannot cancel a timer cheaply. A timer wheel is an
+// array of slots, one per tick, like the face of a clock. Scheduling a timer appends it to the slot of its deadline
+// and cancelling unlinks it from that slot: both O(1). Each tick the wheel advances one slot and fires what is there.
+//
+// One wheel of 256 one-millisecond slots only covers 256 ms, so there are four wheels of 256 slots each:
+// level 0 covers the next 256 ticks, level 1 the next 256 * 256 ticks, and so on (2^32 ticks in total, 49 days at
+// 1 ms). When level 0 wraps around, the next level 1 slot is "cascaded": its timers move down to level 0. Every timer
+// cascades at most three times in its life.
+//
+// TimerWheel is single-threaded. TimerService wraps it with a mutex and one timer thread that ticks while timers
+// are pending, runs the callbacks, and sleeps when the wheel is empty; the ticks that pass while it sleeps are
+// skipped in one step (skipTo) instead of being stepped through when the next timer arrives.
+
+struct TimerId {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0; // Detects cancelling a timer whose slot has been reused
+};
+
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr int levels = 4;
+    static constexpr int slotBits = 8;
+    static constexpr std::uint32_t slotsPerLevel = 1u << slotBits;
+
+    TimerWheel() {
+        for (auto& level : slots) {
+            level.fill(nil);
+        }
+    }
+
+    // Schedule a callback to run at the given tick (absolute); O(1)
+    TimerId schedule(std::uint64_t expiryTick, Callback callback) {
+        const std::uint32_t index = allocateNode();
+        Node& node = nodes[index];
+        node.expiry = std::max(expiryTick, currentTick + 1); // Never in the past: at the earliest the next tick
+        node.callback = std::move(callback);
+        link(index);
+        ++pending;
+        return {index, node.generation};
+    }
+
+    // Unlink a pending timer; returns false if it already fired or was cancelled; O(1)
+    bool cancel(TimerId id) {
+        if (id.index >= nodes.size() || nodes[id.index].generation != id.generation || !nodes[id.index].linked) {
+            return false;
+        }
+        unlink(id.index);
+        releaseNode(id.index);
+        --pending;
+        return true;
+    }
+
+    // Advance to the given tick, appending the callbacks of every expired timer to fired
+    void advance(std::uint64_t toTick, std::vector<Callback>& fired) {
+        while (currentTick < toTick) {
+            ++currentTick;
+            // Cascade from the highest level that wrapped down to level 1
+            for (int level = levels - 1; level >= 1; --level) {
+                if (wrapped(level)) {
+                    cascade(level, slotIndex(currentTick, level));
+                }
+            }
+            std::uint32_t& head = slots[0][slotIndex(currentTick, 0)];
+            while (head != nil) {
+                const std::uint32_t index = head;
+                unlink(index);
+                fired.push_back(std::move(nodes[index].callback));
+                releaseNode(index);
+                --pending;
+            }
+        }
+    }
+
+    // Jump to the given tick without stepping through the ticks in between; only while no timer is pending, since
+    // nothing can fire or cascade then. Going backwards is ignored.
+    void skipTo(std::uint64_t tick) {
+        if (pending != 0) {
+            throw std::logic_error("TimerWheel::skipTo needs an empty wheel");
+        }
+        currentTick = std::max(currentTick, tick);
+    }
+
+    std::uint64_t now() const { return currentTick; }
+    std::size_t size() const { return pending; }
+
+private:
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+
+    struct Node {
+        std::uint64_t expiry = 0;
+        std::uint32_t prev = nil;
+        std::uint32_t next = nil;
+        std::uint32_t generation = 0;
+        std::uint16_t slot = 0; // level * slotsPerLevel + index, needed to unlink a list head
+        bool linked = false;
+        Callback callback;
+    };
+
+    static std::uint32_t slotIndex(std::uint64_t tick, int level) {
+        return static_cast<std::uint32_t>(tick >> (level * slotBits)) & (slotsPerLevel - 1);
+    }
+
+    // True when every level below this one wrapped around at the current tick
+    bool wrapped(int level) const {
+        return (currentTick & ((std::uint64_t{1} << (level * slotBits)) - 1)) == 0;
+    }
+
+    void link(std::uint32_t index) {
+        Node& node = nodes[index];
+        const std::uint64_t delta = node.expiry - currentTick;
+        int level = 0;
+        while (level < levels - 1 && delta >= (std::uint64_t{1} << ((level + 1) * slotBits))) {
+            ++level;
+        }
+        // Beyond the last level: park in the farthest slot, it cascades again when reached
+        const std::uint64_t tick =
+            level == levels - 1 && delta >= (std::uint64_t{1} << (levels * slotBits))
+                ? currentTick + (std::uint64_t{1} << (levels * slotBits)) - 1
+                : node.expiry;
+        const std::uint32_t slot = slotIndex(tick, level);
+        std::uint32_t& head = slots[static_cast<std::size_t>(level)][slot];
+
+        node.slot = static_cast<std::uint16_t>(static_cast<std::uint32_t>(level) * slotsPerLevel + slot);
+        node.prev = nil;
+        node.next = head;
+        if (head != nil) {
+            nodes[head].prev = index;
+        }
+        head = index;
+        node.linked = true;
+    }
+
+    void unlink(std::uint32_t index) {
+        Node& node = nodes[index];
+        if (node.prev != nil) {
+            nodes[node.prev].next = node.next;
+        } else {
+            slots[node.slot / slotsPerLevel][node.slot % slotsPerLevel] = node.next;
+        }
+        if (node.next != nil) {
+            nodes[node.next].prev = node.prev;
+        }
+        node.prev = node.next = nil;
+        node.linked = false;
+    }
+
+    // Move every timer of a higher-level slot down to where it belongs now
+    void cascade(int level, std::uint32_t slot) {
+        std::uint32_t index = std::exchange(slots[static_cast<std::size_t>(level)][slot], nil);
+        while (index != nil) {
+            const std::uint32_t next = nodes[index].next;
+            nodes[index].linked = false;
+            link(index);
+            index = next;
+        }
+    }
+
+    std::uint32_t allocateNode() {
+        if (freeList != nil) {
+            const std::uint32_t index = freeList;
+            freeList = nodes[index].next;
+            nodes[index].next = nil;
+            return index;
+        }
+        nodes.emplace_back();
+        return static_cast<std::uint32_t>(nodes.size() - 1);
+    }
+
+    void releaseNode(std::uint32_t index) {
+        Node& node = nodes[index];
+        node.callback = nullptr;
+        ++node.generation;
+        node.next = freeList;
+        freeList = index;
+    }
+
+    std::array<std::array<std::uint32_t, slotsPerLevel>, levels> slots;
+    std::vector<Node> nodes; // Node pool: timers are indices, not pointers, so the pool can grow
+    std::uint32_t freeList = nil;
+    std::uint64_t currentTick = 0;
+    std::size_t pending = 0;
+};
+
+// Thread-safe timer service: one timer thread drives a TimerWheel with a fixed tick
+class TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = TimerWheel::Callback;
+
+    explicit TimerService(Clock::duration tick = std::chrono::milliseconds(1))
+        : tick(tick), start(Clock::now()), thread([this] { run(); }) {}
+
+    ~TimerService() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        thread.join();
+    }
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    // Run the callback on the timer thread after the delay, rounded up to whole ticks.
+    // Callbacks should be short (e.g. post work or resume a coroutine on a pool).
+    TimerId schedule(Clock::duration delay, Callback callback) {
+        return scheduleAt(Clock::now() + delay, std::move(callback));
+    }
+
+    TimerId scheduleAt(Clock::time_point deadline, Callback callback) {
+        const auto ticks = (deadline - start + tick - Clock::duration(1)) / tick;
+        bool wasEmpty;
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wasEmpty = wheel.size() == 0;
+            if (wasEmpty) {
+                wheel.skipTo(elapsedTicks()); // The wheel stood still while idle; don't replay those ticks
+            }
+            id = wheel.schedule(static_cast<std::uint64_t>(std::max<Clock::rep>(ticks, 0)), std::move(callback));
+        }
+        if (wasEmpty) {
+            wakeUp.notify_one(); // The timer thread sleeps while there is nothing to tick for
+        }
+        return id;
+    }
+
+    bool cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return wheel.cancel(id);
+    }
+
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return wheel.size();
+    }
+
+    Clock::duration tickDuration() const { return tick; }
+
+private:
+    // Whole ticks since the service started
+    std::uint64_t elapsedTicks() const { return static_cast<std::uint64_t>((Clock::now() - start) / tick); }
+
+    void run() {
+        std::vector<Callback> fired;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (wheel.size() == 0) {
+                wheel.skipTo(elapsedTicks());
+                wakeUp.wait(lock);
+                continue;
+            }
+            const auto nextTick = start + tick * static_cast<Clock::rep>(wheel.now() + 1);
+            if (Clock::now() < nextTick) {
+                wakeUp.wait_until(lock, nextTick);
+                continue;
+            }
+            // Catch up on every tick that has passed (the thread may have been descheduled)
+            wheel.advance(elapsedTicks(), fired);
+            lock.unlock(); // Callbacks may schedule or cancel timers
+            for (auto& callback : fired) {
+                callback();
+            }
+            fired.clear();
+            lock.lock();
+        }
+    }
+
+    const Clock::duration tick;
+    const Clock::time_point start;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    TimerWheel wheel;
+    bool stopping = false;
+    std::thread thread; // Declared last so it starts after the wheel exists
+};
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "WorkStealingPool.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// CPU topology, thread pinning and node-local memory.
+//
+// The threads of threads_example.cpp go wherever the OS scheduler puts them, and it may move them later. For
+// memory-bound work that matters twice:
+//
+// - Two hardware threads of one core (SMT siblings, "hyper-threads") share its caches and load/store units, so two
+//   streaming threads on siblings get little more bandwidth than one. Spreading them over cores first does better.
+// - On a machine with several NUMA nodes, memory attached to another node is slower. Linux places a page on the
+//   node of the thread that first writes it ("first touch"), so a buffer should be touched by the thread that will
+//   use it, and that thread should not then migrate to another node.
+//
+// Topology::discover() reads cores, SMT siblings and NUMA nodes from /sys/devices/system (falling back to one node
+// of hardware_concurrency() plain cores elsewhere). placement() orders CPUs for pinning, pinWorkers() pins the
+// workers of a WorkStealingPool, and NodeLocalBuffer allocates memory that is first touched by its owner.
+//
+// In C#, this is ProcessThread.ProcessorAffinity and the GCHeapAffinitize settings.
+
+struct CpuInfo {
+    int id = 0;      // Logical CPU number, as used by sched_setaffinity
+    int core = 0;    // Physical core, unique across packages
+    int package = 0; // Socket
+    int node = 0;    // NUMA node
+};
+
+class Topology {
+public:
+    enum class Placement {
+        Spread,  // One hardware thread per core, cores taken round-robin across nodes; then the SMT siblings
+        Compact, // Fill a node, core by core with all its siblings, before the next
+    };
+
+    static Topology discover() {
+        Topology topology;
+        const std::string cpuRoot = "/sys/devices/system/cpu/";
+        for (int id : parseCpuList(readFile(cpuRoot + "online"))) {
+            const std::string dir = cpuRoot + "cpu" + std::to_string(id) + "/topology/";
+            CpuInfo cpu;
+            cpu.id = id;
+            cpu.package = readInt(dir + "physical_package_id", 0);
+            // core_id is only unique within a package; the lowest sibling's id names the core
+            const auto siblings = parseCpuList(readFile(dir + "thread_siblings_list"));
+            cpu.core = siblings.empty() ? id : siblings.front();
+            topology.cpus.push_back(cpu);
+        }
+        if (topology.cpus.empty()) {
+            const unsigned count = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned id = 0; id < count; ++id) {
+                topology.cpus.push_back({static_cast<int>(id), static_cast<int>(id), 0, 0});
+            }
+            return topology;
+        }
+        for (int node : parseCpuList(readFile("/sys/devices/system/node/online"))) {
+            for (int id : parseCpuList(readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))) {
+                for (CpuInfo& cpu : topology.cpus) {
+                    if (cpu.id == id) {
+                        cpu.node = node;
+                    }
+                }
+            }
+        }
+        return topology;
+    }
+
+    const std::vector<CpuInfo>& allCpus() const { return cpus; }
+
+    std::size_t coreCount() const { return distinct([](const CpuInfo& cpu) { return cpu.core; }); }
+    std::size_t nodeCount() const { return distinct([](const CpuInfo& cpu) { return cpu.node; }); }
+    std::size_t packageCount() const { return distinct([](const CpuInfo& cpu) { return cpu.package; }); }
+
+    int nodeOf(int cpuId) const {
+        for (const CpuInfo& cpu : cpus) {
+            if (cpu.id == cpuId) {
+                return cpu.node;
+            }
+        }
+        return 0;
+    }
+
+    // Logical CPUs in the order threads should be pinned to them
+    std::vector<int> placement(Placement how) const {
+        std::vector<CpuInfo> sorted = cpus; // Compact order
+        std::sort(sorted.begin(), sorted.end(), [](const CpuInfo& a, const CpuInfo& b) {
+            return std::tie(a.node, a.core, a.id) < std::tie(b.node, b.core, b.id);
+        });
+        if (how == Placement::Spread) {
+            // Rank every CPU among its core's siblings (0 = first) and its core among its node's cores
+            std::vector<int> siblingRank(sorted.size()), coreRank(sorted.size());
+            for (std::size_t i = 0; i < sorted.size(); ++i) {
+                const bool sameCore = i > 0 && sorted[i].core == sorted[i - 1].core;
+                const bool sameNode = i > 0 && sorted[i].node == sorted[i - 1].node;
+                siblingRank[i] = sameCore ? siblingRank[i - 1] + 1 : 0;
+                coreRank[i] = !sameNode ? 0 : sameCore ? coreRank[i - 1] : coreRank[i - 1] + 1;
+            }
+            std::vector<std::size_t> order(sorted.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return std::tie(siblingRank[a], coreRank[a], sorted[a].node) <
+                       std::tie(siblingRank[b], coreRank[b], sorted[b].node);
+            });
+            std::vector<CpuInfo> spread;
+            for (std::size_t i : order) {
+                spread.push_back(sorted[i]);
+            }
+            sorted = std::move(spread);
+        }
+        std::vector<int> ids;
+        for (const CpuInfo& cpu : sorted) {
+            ids.push_back(cpu.id);
+        }
+        return ids;
+    }
+
+    void print(std::ostream& out) const {
+        out << cpus.size() << " logical CPUs, " << coreCount() << " cores, " << packageCount() << " packages, "
+            << nodeCount() << " NUMA nodes\n";
+        for (const CpuInfo& cpu : cpus) {
+            out << "  cpu" << cpu.id << ": core " << cpu.core << ", package " << cpu.package << ", node " << cpu.node
+                << "\n";
+        }
+    }
+
+    // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+    static std::vector<int> parseCpuList(const std::string& text) {
+        std::vector<int> ids;
+        std::stringstream ranges(text);
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            if (range.find_first_of("0123456789") == std::string::npos) {
+                continue;
+            }
+            const auto dash = range.find('-');
+            const int first = std::atoi(range.c_str());
+            const int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+            for (int id = first; id <= last; ++id) {
+                ids.push_back(id);
+            }
+        }
+        return ids;
+    }
+
+private:
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        std::string text;
+        std::getline(file, text);
+        return text;
+    }
+
+    static int readInt(const std::string& path, int fallback) {
+        const std::string text = readFile(path);
+        return text.empty() ? fallback : std::atoi(text.c_str());
+    }
+
+    template <typename Key>
+    std::size_t distinct(Key key) const {
+        std::set<int> values;
+        for (const CpuInfo& cpu : cpus) {
+            values.insert(key(cpu));
+        }
+        return values.size();
+    }
+
+    std::vector<CpuInfo> cpus;
+};
+
+// Restrict the calling thread to one logical CPU; false if the OS refused or does not support it
+inline bool pinThisThread(int cpuId) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpuId, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpuId;
+    return false;
+#endif
+}
+
+// The CPU the calling thread runs on right now, or -1 if unknown
+inline int currentCpu() {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// Run f(workerIndex) once on every worker of the pool and wait. Must be called from outside the pool.
+// Each task waits until all of them have started, so no worker can run two of them: they land on distinct workers.
+template <typename F>
+void runOnEachWorker(WorkStealingPool& pool, F f) {
+    const unsigned workers = pool.size();
+    std::atomic<unsigned> started{0};
+    std::atomic<unsigned> finished{0};
+    for (unsigned i = 0; i < workers; ++i) {
+        pool.post([&] {
+            started.fetch_add(1);
+            while (started.load() < workers) {
+                std::this_thread::yield();
+            }
+            f(static_cast<unsigned>(pool.currentWorkerIndex()));
+            if (finished.fetch_add(1) + 1 == workers) {
+                finished.notify_all();
+            }
+        });
+    }
+    for (unsigned done = finished.load(); done < workers; done = finished.load()) {
+        finished.wait(done);
+    }
+}
+
+// Pin worker i to the i-th CPU of the placement (wrapping around if the pool has more workers than CPUs).
+// Returns how many workers were pinned.
+inline unsigned pinWorkers(WorkStealingPool& pool, const Topology& topology,
+                           Topology::Placement how = Topology::Placement::Spread) {
+    const std::vector<int> cpus = topology.placement(how);
+    std::atomic<unsigned> pinned{0};
+    runOnEachWorker(pool, [&](unsigned worker) {
+        if (pinThisThread(cpus[worker % cpus.size()])) {
+            pinned.fetch_add(1);
+        }
+    });
+    return pinned.load();
+}
+
+// A buffer whose pages are first written by the thread that constructs it, so with a pinned owner they are
+// allocated on the owner's NUMA node. Construct it on the thread that will use it.
+template <typename T>
+class NodeLocalBuffer {
+    static_assert(std::is_trivially_default_constructible_v<T>, "memory is zeroed, not constructed");
+
+public:
+    explicit NodeLocalBuffer(std::size_t count)
+        : count(count), memory(static_cast<T*>(::operator new(bytes(count), std::align_val_t{pageSize}))) {
+        // A large allocation comes straight from mmap with no physical pages yet; these writes decide where they go
+        auto* raw = reinterpret_cast<unsigned char*>(memory.get());
+        for (std::size_t offset = 0; offset < bytes(count); offset += pageSize) {
+            std::fill_n(raw + offset, std::min(pageSize, bytes(count) - offset), static_cast<unsigned char>(0));
+        }
+    }
+
+    T* data() { return memory.get(); }
+    const T* data() const { return memory.get(); }
+    std::size_t size() const { return count; }
+    T& operator[](std::size_t i) { return memory.get()[i]; }
+    const T& operator[](std::size_t i) const { return memory.get()[i]; }
+
+private:
+    static constexpr std::size_t pageSize = 4096;
+
+    static std::size_t bytes(std::size_t count) { return std::max<std::size_t>(1, count * sizeof(T)); }
+
+    struct PageDelete {
+        void operator()(T* p) const { ::operator delete(p, std::align_val_t{pageSize}); }
+    };
+
+    std::size_t count;
+    std::unique_ptr<T, PageDelete> memory;
+};
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A fixed-size work-stealing thread pool.
+//
+// std::async(std::launch::async, ...) starts a new OS thread for every task. Creating and joining a thread costs
+// tens of microseconds, which dwarfs tiny tasks. This pool starts its threads once and reuses them:
+//
+// - Every worker owns a Chase-Lev deque. Tasks submitted from inside a worker go to the bottom of its own deque and
+//   the worker pops them LIFO (cache-hot). Idle workers steal from the top of other workers' deques (FIFO, oldest
+//   and usually biggest work first).
+// - Tasks submitted from outside the pool go to a global injection queue. A worker takes a small batch from it at
+//   once, so other workers can steal part of that batch.
+// - Workers that find no work park on an atomic (futex on Linux) instead of spinning, and are woken by the next
+//   submit.
+// - An exception escaping a post()ed task would reach the worker thread and call std::terminate; the pool catches
+//   it, reports it on std::cerr and counts it (unhandledExceptions()). submit() delivers exceptions through the
+//   future instead.
+//
+// In C#, this is what the .NET ThreadPool does behind Task.Run: per-thread local queues, work stealing and a global
+// queue.
+
+// Lock-free work-stealing deque (Chase & Lev 2005, with the C11 memory orderings from Le et al. 2013).
+// push/pop may only be called by the owner thread; steal may be called by any thread.
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "slots are std::atomic<T>");
+
+public:
+    explicit ChaseLevDeque(std::int64_t capacity = 256) {
+        auto initial = std::make_unique<Buffer>(capacity);
+        buffer.store(initial.get(), std::memory_order_relaxed);
+        buffers.push_back(std::move(initial));
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    void push(T item) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    bool pop(T& item) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed); // Deque was empty
+            return false;
+        }
+        item = a->get(b);
+        if (t == b) {
+            // Last item: race against thieves for it
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                         std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool steal(T& item) {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        Buffer* a = buffer.load(std::memory_order_acquire);
+        item = a->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(std::int64_t capacity)
+            : capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[static_cast<std::size_t>(capacity)]) {}
+
+        T get(std::int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t index, T item) { slots[index & mask].store(item, std::memory_order_relaxed); }
+
+        const std::int64_t capacity; // Always a power of two
+        const std::int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, std::int64_t b, std::int64_t t) {
+        auto bigger = std::make_unique<Buffer>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Buffer* raw = bigger.get();
+        // A thief may still be reading the old buffer, so it is only freed with the deque
+        buffers.push_back(std::move(bigger));
+        buffer.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top{0};    // Thieves take from here
+    alignas(64) std::atomic<std::int64_t> bottom{0}; // Owner pushes and pops here
+    std::atomic<Buffer*> buffer{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers; // Owner only
+};
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency())) {
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers[i]->thread = std::thread([this, i] { run(i); });
+        }
+    }
+
+    // Runs every task that was already submitted, then joins the workers
+    ~WorkStealingPool() {
+        stopping.store(true);
+        wakeWorkers(true);
+        for (auto& worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Run f(args...) on the pool and get its result through a std::future, like std::async
+    template <typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        using Result = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        std::packaged_task<Result()> task(
+            [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable {
+                return std::invoke(std::move(f), std::move(args)...);
+            });
+        auto future = task.get_future();
+        post(std::move(task));
+        return future;
+    }
+
+    // Fire-and-forget: no future, no shared state, the cheapest way to run a task. Nobody can observe what it
+    // throws, so an escaping exception is only reported (see unhandledExceptions).
+    template <typename F>
+    void post(F&& f) {
+        schedule(new TaskImpl<std::decay_t<F>>(std::forward<F>(f)));
+    }
+
+    // Run one pending task on the calling worker, if there is one. A task that waits for another task's result
+    // calls this in its wait loop ("help while waiting") so the awaited task cannot get stuck behind it.
+    bool tryRunPendingTask() {
+        if (currentPool != this) {
+            return false;
+        }
+        thread_local std::uint32_t random = 0x2545F491u;
+        Task* task = findTask(static_cast<unsigned>(currentIndex), random);
+        if (!task) {
+            return false;
+        }
+        runTask(task);
+        return true;
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Number of exceptions that escaped post()ed tasks so far
+    std::size_t unhandledExceptions() const { return unhandled.load(std::memory_order_relaxed); }
+
+    // Index of the calling worker in this pool, or -1 when called from another thread
+    int currentWorkerIndex() const { return currentPool == this ? currentIndex : -1; }
+
+    // True when the calling worker has no tasks queued locally, i.e. nothing a thief could take from it right now
+    // (used by lazy binary splitting in ParallelAlgorithms.h); also true outside the pool
+    bool localQueueEmpty() const {
+        return currentPool != this || workers[static_cast<std::size_t>(currentIndex)]->deque.empty();
+    }
+
+private:
+    struct Task {
+        virtual ~Task() = default;
+        virtual void run() = 0;
+    };
+
+    template <typename F>
+    struct TaskImpl final : Task {
+        explicit TaskImpl(F&& f) : f(std::move(f)) {}
+        explicit TaskImpl(const F& f) : f(f) {}
+        void run() override { f(); }
+        F f;
+    };
+
+    struct Worker {
+        ChaseLevDeque<Task*> deque;
+        std::thread thread;
+    };
+
+    static constexpr std::size_t injectionBatch = 32;
+
+    // Run and free a task; what it throws must not unwind through the worker (or through the task that is helping
+    // while it waits)
+    void runTask(Task* task) {
+        std::unique_ptr<Task> owned(task);
+        try {
+            owned->run();
+        } catch (const std::exception& e) {
+            unhandled.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "WorkStealingPool: task threw " << e.what() << "\n";
+        } catch (...) {
+            unhandled.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "WorkStealingPool: task threw a non-standard exception\n";
+        }
+    }
+
+    void schedule(Task* task) {
+        if (currentPool == this) {
+            workers[static_cast<std::size_t>(currentIndex)]->deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            injection.push_back(task);
+        }
+        wakeWorkers(false);
+    }
+
+    // Dekker-style handshake with park(): bump the epoch first, then look for sleepers
+    void wakeWorkers(bool all) {
+        workEpoch.fetch_add(1);
+        if (sleepers.load() > 0) {
+            if (all) {
+                workEpoch.notify_all();
+            } else {
+                workEpoch.notify_one();
+            }
+        }
+    }
+
+    Task* findTask(unsigned self, std::uint32_t& random) {
+        Task* task = nullptr;
+        if (workers[self]->deque.pop(task)) {
+            return task;
+        }
+        if (takeFromInjection(self, task)) {
+            return task;
+        }
+        // Steal, starting from a random victim so thieves do not all hit worker 0
+        const auto count = static_cast<unsigned>(workers.size());
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        const unsigned start = random % count;
+        for (unsigned i = 0; i < count; ++i) {
+            const unsigned victim = (start + i) % count;
+            if (victim != self && workers[victim]->deque.steal(task)) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    // Take a batch from the global queue: run the first task, keep the rest in our deque where it can be stolen
+    bool takeFromInjection(unsigned self, Task*& task) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (injection.empty()) {
+            return false;
+        }
+        task = injection.front();
+        injection.pop_front();
+        for (std::size_t i = 1; i < injectionBatch && !injection.empty(); ++i) {
+            workers[self]->deque.push(injection.front());
+            injection.pop_front();
+        }
+        return true;
+    }
+
+    void run(unsigned self) {
+        currentPool = this;
+        currentIndex = static_cast<int>(self);
+        std::uint32_t random = 0x9E3779B9u * (self + 1);
+
+        for (;;) {
+            const std::uint32_t epoch = workEpoch.load();
+            if (Task* task = findTask(self, random)) {
+                runTask(task);
+                continue;
+            }
+            if (stopping.load()) {
+                return; // Nothing left anywhere
+            }
+            // Park until someone submits; re-check the epoch so a submit racing with us is never lost
+            sleepers.fetch_add(1);
+            if (workEpoch.load() == epoch) {
+                workEpoch.wait(epoch);
+            }
+            sleepers.fetch_sub(1);
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex injectionMutex;
+    std::deque<Task*> injection;
+
+    alignas(64) std::atomic<std::uint32_t> workEpoch{0};
+    alignas(64) std::atomic<int> sleepers{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::size_t> unhandled{0};
+
+    static inline thread_local WorkStealingPool* currentPool = nullptr;
+    static inline thread_local int currentIndex = -1;
+};
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <stdexcept>
+#include <iomanip>
+#include "WorkStealingPool.h"
+#include "Continuations.h"
+
+// Function to simulate a long-running task (same as in tasks_example.cpp, with a shorter delay)
+int longRunningTask(int input) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return input * 2;
+}
+
+int tinyStep(int input) { return input + 1; }
+
+template <typename F>
+double elapsedMillis(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main() {
+    WorkStealingPool pool(2);
+
+    // Step 1: with std::future, running longRunningTask on the result of longRunningTask means some thread
+    // has to sit in .get() for the whole first task:
+    //     auto first = std::async(std::launch::async, longRunningTask, 10);
+    //     auto second = std::async(std::launch::async, [&first] { return longRunningTask(first.get()); });
+    // With continuations the second step is only scheduled once the first one has finished.
+    std::cout << "Starting a chain of three long-running tasks..." << std::endl;
+    Future<int> chain = asyncOn(pool, longRunningTask, 10)
+                            .then(pool, longRunningTask)
+                            .then(pool, [](int value) { return longRunningTask(value); });
+    std::cout << "Doing other work while the chain runs..." << std::endl;
+    std::cout << "Chain result: " << chain.get() << std::endl; // Only main blocks, at the very end
+
+    // Step 2: fan-out / fan-in without a waiting thread
+    std::vector<Future<int>> parts;
+    for (int i = 1; i <= 4; ++i) {
+        parts.push_back(asyncOn(pool, longRunningTask, i));
+    }
+    Future<int> total = whenAll(parts).then([](const std::vector<int>& values) {
+        int sum = 0;
+        for (int v : values) {
+            sum += v;
+        }
+        return sum;
+    });
+    std::cout << "whenAll sum: " << total.get() << std::endl;
+
+    // Step 3: first result wins
+    std::vector<Future<int>> racers;
+    racers.push_back(asyncOn(pool, [] { std::this_thread::sleep_for(std::chrono::milliseconds(300)); return 1; }));
+    racers.push_back(asyncOn(pool, [] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); return 2; }));
+    auto [index, value] = whenAny(racers).get();
+    std::cout << "whenAny winner: racer " << index << " with value " << value << std::endl;
+
+    // Step 4: exceptions skip the remaining steps and surface in get()
+    Future<int> failing = asyncOn(pool, [] { return longRunningTask(1); })
+                              .then(pool, [](int) -> int { throw std::runtime_error("step 2 failed"); })
+                              .then(pool, [](int value) { return value * 100; }); // Never runs
+    try {
+        failing.get();
+    } catch (const std::exception& e) {
+        std::cout << "Chain failed: " << e.what() << std::endl;
+    }
+
+    // Step 5: overhead of continuations versus blocking get()
+    constexpr int steps = 100'000;
+    int blockingResult = 0;
+    const double blockingMs = elapsedMillis([&] {
+        // Each step waits for the previous one: submit, block in get(), submit again...
+        for (int i = 0; i < steps; ++i) {
+            blockingResult = pool.submit(tinyStep, blockingResult).get();
+        }
+    });
+
+    int continuationResult = 0;
+    const double continuationMs = elapsedMillis([&] {
+        // The whole chain is described up front; workers hand each result to the next step
+        Future<int> f = makeReadyFuture(0);
+        for (int i = 0; i < steps; ++i) {
+            f = f.then(pool, tinyStep);
+        }
+        continuationResult = f.get();
+    });
+
+    constexpr int fanOut = 100'000;
+    const double getLoopMs = elapsedMillis([&] {
+        std::vector<std::future<int>> futures;
+        futures.reserve(fanOut);
+        for (int i = 0; i < fanOut; ++i) {
+            futures.push_back(pool.submit(tinyStep, i));
+        }
+        long long sum = 0;
+        for (auto& f : futures) {
+            sum += f.get();
+        }
+    });
+    const double whenAllMs = elapsedMillis([&] {
+        std::vector<Future<int>> futures;
+        futures.reserve(fanOut);
+        for (int i = 0; i < fanOut; ++i) {
+            futures.push_back(asyncOn(pool, tinyStep, i));
+        }
+        whenAll(std::move(futures)).get();
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\nBenchmark on " << pool.size() << " workers (" << steps << " dependent steps, " << fanOut
+              << " independent tasks)\n";
+    std::cout << "Dependent chain, blocking get() per step: " << std::setw(8) << blockingMs << " ms (result "
+              << blockingResult << ")\n";
+    std::cout << "Dependent chain, then():                  " << std::setw(8) << continuationMs << " ms (result "
+              << continuationResult << ")\n";
+    std::cout << "Fan-in, std::future + get() loop:         " << std::setw(8) << getLoopMs << " ms\n";
+    std::cout << "Fan-in, whenAll():                        " << std::setw(8) << whenAllMs << " ms\n";
+
+    return 0;
+}
+
+/*
+Sample Output (benchmark numbers vary by machine; these come from a single-core machine):
+Starting a chain of three long-running tasks...
+Doing other work while the chain runs...
+Chain result: 80
+whenAll sum: 20
+whenAny winner: racer 1 with value 2
+Chain failed: step 2 failed
+
+Benchmark on 2 workers (100000 dependent steps, 100000 independent tasks)
+Dependent chain, blocking get() per step:    373.3 ms (result 100000)
+Dependent chain, then():                      51.9 ms (result 100000)
+Fan-in, std::future + get() loop:            100.7 ms
+Fan-in, whenAll():                            80.4 ms
+*/
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include "BoundedQueue.h"
+
+// The producer/consumer queue threads_example.cpp would build from its global mutex and condition_variable:
+// every operation takes the one lock, and a full or empty queue waits on a condition variable
+template <typename T>
+class MutexQueue {
+public:
+    using value_type = T;
+
+    explicit MutexQueue(std::size_t capacity) : capacity(capacity) {}
+
+    void push(T value) {
+        std::unique_lock<std::mutex> lock(mtx);
+        notFull.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(std::move(value));
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+
+    T pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        notEmpty.wait(lock, [this] { return !items.empty(); });
+        T value = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return value;
+    }
+
+private:
+    const std::size_t capacity;
+    std::mutex mtx;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<T> items;
+};
+
+// What travels through the benchmark queues: the time it was pushed, or -1 to tell a consumer to stop
+struct Message {
+    std::int64_t sentNs = 0;
+};
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct RunResult {
+    double millionOpsPerSecond;
+    double p50Ns;
+    double p99Ns;
+};
+
+// Every producer pushes its share of the messages; consumers record how long each message waited in the queue
+template <typename Queue>
+RunResult runProducersConsumers(int producers, int consumers, int messages, std::size_t capacity) {
+    Queue queue(capacity);
+    std::vector<std::vector<std::int64_t>> latencies(static_cast<std::size_t>(consumers));
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> consumerThreads;
+    for (int c = 0; c < consumers; ++c) {
+        consumerThreads.emplace_back([&queue, &latencies, c, messages, consumers] {
+            auto& mine = latencies[static_cast<std::size_t>(c)];
+            mine.reserve(static_cast<std::size_t>(messages / consumers * 2));
+            for (;;) {
+                const Message message = queue.pop();
+                if (message.sentNs < 0) {
+                    return;
+                }
+                mine.push_back(nowNs() - message.sentNs);
+            }
+        });
+    }
+    std::vector<std::thread> producerThreads;
+    for (int p = 0; p < producers; ++p) {
+        producerThreads.emplace_back([&queue, p, messages, producers] {
+            const int share = messages / producers + (p < messages % producers ? 1 : 0);
+            for (int i = 0; i < share; ++i) {
+                queue.push(Message{nowNs()});
+            }
+        });
+    }
+    for (auto& thread : producerThreads) {
+        thread.join();
+    }
+    for (int c = 0; c < consumers; ++c) {
+        queue.push(Message{-1});
+    }
+    for (auto& thread : consumerThreads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::int64_t> all;
+    all.reserve(static_cast<std::size_t>(messages));
+    for (auto& mine : latencies) {
+        all.insert(all.end(), mine.begin(), mine.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto at = [&all](double q) { return static_cast<double>(all[static_cast<std::size_t>(q * (all.size() - 1))]); };
+    return {messages / seconds / 1e6, at(0.50), at(0.99)};
+}
+
+void printRow(const std::string& name, const RunResult& r) {
+    std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << r.millionOpsPerSecond << std::setprecision(0) << std::setw(12) << r.p50Ns
+              << std::setw(14) << r.p99Ns << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Step 1: a producer hands work to two consumers through a bounded, blocking, lock-free queue
+    BlockingQueue<MpmcQueue<std::string>> work(4);
+    std::mutex coutMutex;
+    std::vector<std::thread> workers;
+    for (int id = 0; id < 2; ++id) {
+        workers.emplace_back([&work, &coutMutex, id] {
+            for (std::string item = work.pop(); !item.empty(); item = work.pop()) {
+                std::lock_guard<std::mutex> lock(coutMutex);
+                std::cout << "Consumer " << id << " got " << item << std::endl;
+            }
+        });
+    }
+    for (int i = 0; i < 6; ++i) {
+        work.push("job " + std::to_string(i)); // Blocks while 4 jobs are waiting
+    }
+    work.push(std::string{}); // One empty string per consumer means "stop"
+    work.push(std::string{});
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Step 2: throughput and hand-off latency at different producer/consumer counts
+    const int messages = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+    constexpr std::size_t capacity = 1024;
+    std::cout << "\nBenchmark: " << messages << " messages, capacity " << capacity << ", "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::left << std::setw(30) << "queue (producers x consumers)" << std::right << std::setw(10)
+              << "Mops/s" << std::setw(12) << "p50 ns" << std::setw(14) << "p99 ns" << "\n";
+
+    printRow("SpscQueue 1x1", runProducersConsumers<BlockingQueue<SpscQueue<Message>>>(1, 1, messages, capacity));
+    printRow("MpmcQueue 1x1", runProducersConsumers<BlockingQueue<MpmcQueue<Message>>>(1, 1, messages, capacity));
+    printRow("mutex + cv 1x1", runProducersConsumers<MutexQueue<Message>>(1, 1, messages, capacity));
+    const std::pair<int, int> shapes[] = {{2, 2}, {4, 4}, {4, 1}, {1, 4}};
+    for (auto [producers, consumers] : shapes) {
+        const std::string shape = " " + std::to_string(producers) + "x" + std::to_string(consumers);
+        printRow("MpmcQueue" + shape,
+                 runProducersConsumers<BlockingQueue<MpmcQueue<Message>>>(producers, consumers, messages, capacity));
+        printRow("mutex + cv" + shape,
+                 runProducersConsumers<MutexQueue<Message>>(producers, consumers, messages, capacity));
+    }
+
+    return 0;
+}
+
+/*
+Sample Output (benchmark numbers vary by machine; these come from a single-core machine, where only one thread runs at
+a time: a message waits for the consumer's next time slice, so latency is mostly time spent in a full queue):
+Consumer 1 got job 0
+Consumer 1 got job 1
+Consumer 1 got job 2
+Consumer 1 got job 3
+Consumer 0 got job 4
+Consumer 0 got job 5
+
+Benchmark: 1000000 messages, capacity 1024, 1 hardware threads
+queue (producers x consumers)     Mops/s      p50 ns        p99 ns
+SpscQueue 1x1                       8.21       62003         90810
+MpmcQueue 1x1                       7.50       68000        100759
+mutex + cv 1x1                      5.24       98882        193999
+MpmcQueue 2x2                       7.54       65849        150157
+mutex + cv 2x2                      5.31       94742        239238
+MpmcQueue 4x4                       8.44       54483        100626
+mutex + cv 4x4                      4.67      100027        193706
+MpmcQueue 4x1                       7.57       68521        107484
+mutex + cv 4x1                      1.36      686463       1773914
+MpmcQueue 1x4                       6.97       69553         87108
+mutex + cv 1x4                      1.25       96559        135171
+*/
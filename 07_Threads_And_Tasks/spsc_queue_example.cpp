@@ -0,0 +1,264 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include "BoundedQueue.h"
+#include "SpinWait.h"
+#include "Topology.h"
+
+// NoobQueue from 05_STL/queue_example_noob.cpp: a fixed array, one thread only
+class NoobQueue {
+private:
+    int data[100]; // Fixed-size array for simplicity
+    int frontIndex;
+    int backIndex;
+
+public:
+    NoobQueue() : frontIndex(0), backIndex(0) {}
+
+    void push(int value) {
+        data[backIndex++] = value;
+    }
+
+    void pop() {
+        if (frontIndex < backIndex) {
+            ++frontIndex;
+        }
+    }
+
+    int front() const {
+        return data[frontIndex];
+    }
+
+    bool empty() const {
+        return frontIndex == backIndex;
+    }
+};
+
+// The obvious way to share std::queue (09_queue_example.cpp) between threads: one mutex around it
+template <typename T>
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : capacity(capacity) {}
+
+    bool tryPush(T value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (items.size() == capacity) {
+            return false;
+        }
+        items.push(value);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (items.empty()) {
+            return false;
+        }
+        value = items.front();
+        items.pop();
+        return true;
+    }
+
+    // One lock per batch, like SpscQueue's one index store per batch
+    template <typename InputIt>
+    std::size_t tryPushBatch(InputIt first, std::size_t count) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::size_t pushed = 0;
+        for (; pushed < count && items.size() < capacity; ++pushed, ++first) {
+            items.push(*first);
+        }
+        return pushed;
+    }
+
+    template <typename OutputIt>
+    std::size_t tryPopBatch(OutputIt out, std::size_t maxCount) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::size_t popped = 0;
+        for (; popped < maxCount && !items.empty(); ++popped, ++out) {
+            *out = items.front();
+            items.pop();
+        }
+        return popped;
+    }
+
+private:
+    const std::size_t capacity;
+    std::mutex mtx;
+    std::queue<T> items;
+};
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Neither queue blocks: a side that finds the queue full or empty spins a little, then yields its time slice
+void backoff(SpinWait& spin) {
+    if (!spin.spinOnce()) {
+        std::this_thread::yield();
+    }
+}
+
+struct RunResult {
+    double millionOpsPerSecond;
+    double p50Ns;
+    double p99Ns;
+    double p999Ns;
+};
+
+// The producer sends `messages` timestamps in batches of `batch`; the consumer pops in batches of the same size and
+// records how long each timestamp took to arrive. Each thread is pinned to its own CPU when there are two.
+template <typename Queue>
+RunResult run(std::size_t messages, std::size_t batch, int producerCpu, int consumerCpu) {
+    Queue queue(1024);
+    std::vector<std::int64_t> latencies(messages);
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread consumer([&] {
+        pinThisThread(consumerCpu);
+        std::vector<std::int64_t> buffer(batch);
+        SpinWait spin;
+        for (std::size_t received = 0; received < messages;) {
+            const std::size_t popped = queue.tryPopBatch(buffer.begin(), std::min(batch, messages - received));
+            if (popped == 0) {
+                backoff(spin);
+                continue;
+            }
+            spin.reset();
+            const std::int64_t now = nowNs();
+            for (std::size_t i = 0; i < popped; ++i) {
+                latencies[received + i] = now - buffer[i];
+            }
+            received += popped;
+        }
+    });
+    std::thread producer([&] {
+        pinThisThread(producerCpu);
+        std::vector<std::int64_t> buffer(batch);
+        SpinWait spin;
+        for (std::size_t sent = 0; sent < messages;) {
+            const std::size_t count = std::min(batch, messages - sent);
+            const std::int64_t now = nowNs();
+            std::fill_n(buffer.begin(), count, now);
+            for (std::size_t done = 0; done < count;) {
+                const std::size_t pushed = queue.tryPushBatch(buffer.begin() + static_cast<std::ptrdiff_t>(done),
+                                                              count - done);
+                if (pushed == 0) {
+                    backoff(spin);
+                } else {
+                    spin.reset();
+                    done += pushed;
+                }
+            }
+            sent += count;
+        }
+    });
+    producer.join();
+    consumer.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](double q) {
+        return static_cast<double>(latencies[static_cast<std::size_t>(q * static_cast<double>(latencies.size() - 1))]);
+    };
+    return {static_cast<double>(messages) / seconds / 1e6, at(0.50), at(0.99), at(0.999)};
+}
+
+void printRow(const std::string& name, const RunResult& r) {
+    std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << r.millionOpsPerSecond << std::setprecision(0) << std::setw(12) << r.p50Ns
+              << std::setw(12) << r.p99Ns << std::setw(12) << r.p999Ns << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Step 1: the NoobQueue demo, on one thread
+    NoobQueue q;
+    q.push(10);
+    q.push(20);
+    q.push(30);
+    std::cout << "NoobQueue elements: ";
+    while (!q.empty()) {
+        std::cout << q.front() << " ";
+        q.pop();
+    }
+    std::cout << "\n";
+
+    // Step 2: the same values handed from one thread to another. No lock and no CAS: each side writes only its own
+    // index.
+    SpscQueue<int> spsc(4);
+    std::thread producer([&spsc] {
+        for (int value : {10, 20, 30, -1}) {
+            while (!spsc.tryPush(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::cout << "SpscQueue elements: ";
+    for (int value = 0;;) {
+        if (!spsc.tryPop(value)) {
+            std::this_thread::yield();
+        } else if (value < 0) {
+            break;
+        } else {
+            std::cout << value << " ";
+        }
+    }
+    producer.join();
+    std::cout << "\n";
+
+    // Batches: 5 values in with one index store, then out with another
+    const int in[] = {1, 2, 3, 4, 5};
+    int out[8] = {};
+    SpscQueue<int> batched(8);
+    const std::size_t pushed = batched.tryPushBatch(std::begin(in), 5);
+    const std::size_t popped = batched.tryPopBatch(std::begin(out), 8);
+    std::cout << "Batch: pushed " << pushed << ", popped " << popped << ": ";
+    for (std::size_t i = 0; i < popped; ++i) {
+        std::cout << out[i] << " ";
+    }
+    std::cout << "\n";
+
+    // Step 3: throughput and hand-off latency between two pinned threads, one message or a batch at a time
+    const std::size_t messages = argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+    const std::vector<int> cpus = Topology::discover().placement(Topology::Placement::Spread);
+    const int producerCpu = cpus.front();
+    const int consumerCpu = cpus.size() > 1 ? cpus[1] : cpus.front();
+    std::cout << "\nBenchmark: " << messages << " messages, capacity 1024, producer on CPU " << producerCpu
+              << ", consumer on CPU " << consumerCpu << "\n";
+    std::cout << std::left << std::setw(30) << "queue" << std::right << std::setw(10) << "Mops/s" << std::setw(12)
+              << "p50 ns" << std::setw(12) << "p99 ns" << std::setw(12) << "p99.9 ns" << "\n";
+    for (std::size_t batch : {1, 16, 256}) {
+        const std::string suffix = batch == 1 ? "" : ", batch " + std::to_string(batch);
+        printRow("SpscQueue" + suffix, run<SpscQueue<std::int64_t>>(messages, batch, producerCpu, consumerCpu));
+        printRow("mutex + std::queue" + suffix,
+                 run<LockedQueue<std::int64_t>>(messages, batch, producerCpu, consumerCpu));
+    }
+
+    return 0;
+}
+
+/*
+Sample Output (timings vary by machine; these come from a single-core x86-64 machine, so both threads share CPU 0
+and every hand-off waits for a time slice: latencies there are scheduler quanta, not cache-line transfers. On two
+cores the single-message p50 drops to around a hundred nanoseconds):
+NoobQueue elements: 10 20 30 
+SpscQueue elements: 10 20 30 
+Batch: pushed 5, popped 5: 1 2 3 4 5 
+
+Benchmark: 2000000 messages, capacity 1024, producer on CPU 0, consumer on CPU 0
+queue                             Mops/s      p50 ns      p99 ns    p99.9 ns
+SpscQueue                           9.28       53867       75097      287437
+mutex + std::queue                  6.24       79623      109952      535222
+SpscQueue, batch 16                84.18        5722       12651       51268
+mutex + std::queue, batch 16       47.96       10621       23107       44162
+SpscQueue, batch 256              146.75        3882        9524       28873
+mutex + std::queue, batch 256     119.90        4869       11341       27285
+*/
@@ -0,0 +1,191 @@
+#include <iostream>
+#include <thread>
+#include <future>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <iomanip>
+#include "TaskCache.h"
+
+std::atomic<int> computations{0};
+
+// longRunningTask from tasks_example.cpp, with a shorter delay and a counter of how often it really runs
+int longRunningTask(int input) {
+    ++computations;
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return input * 2;
+}
+
+template <typename F>
+double millisOf(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void printStats(const char* name, const TaskCacheStats& stats) {
+    std::cout << name << ": " << stats.hits << " hits (" << stats.joinedHits << " joined a running computation), "
+              << stats.misses << " misses, " << stats.evictions << " evictions, " << stats.failures
+              << " failures, hit rate " << std::fixed << std::setprecision(1) << 100.0 * stats.hitRate() << "%\n";
+}
+
+// Keys drawn from a Zipf distribution: a few keys are very popular, most are rare (like real request traffic)
+class ZipfKeys {
+public:
+    ZipfKeys(int keys, double exponent, unsigned seed) : random(seed) {
+        std::vector<double> weights(static_cast<std::size_t>(keys));
+        for (int k = 0; k < keys; ++k) {
+            weights[static_cast<std::size_t>(k)] = 1.0 / std::pow(k + 1, exponent);
+        }
+        distribution = std::discrete_distribution<int>(weights.begin(), weights.end());
+    }
+
+    int next() { return distribution(random); }
+
+private:
+    std::mt19937 random;
+    std::discrete_distribution<int> distribution;
+};
+
+int main() {
+    // Step 1: the deferred task of tasks_example.cpp, asked for twice
+    std::cout << "std::launch::deferred, twice:\n";
+    for (int i = 0; i < 2; ++i) {
+        const double millis = millisOf([] { std::async(std::launch::deferred, longRunningTask, 5).get(); });
+        std::cout << "  " << std::fixed << std::setprecision(1) << millis << " ms\n";
+    }
+    Memoized<int(int)> cachedTask(longRunningTask, 100);
+    std::cout << "Memoized, twice:\n";
+    for (int i = 0; i < 2; ++i) {
+        int result = 0;
+        const double millis = millisOf([&] { result = cachedTask(5).get(); });
+        std::cout << "  " << millis << " ms -> " << result << "\n";
+    }
+
+    // Step 2: single flight. Eight threads ask for the same key at once; it is computed once.
+    computations = 0;
+    std::vector<std::thread> threads;
+    std::vector<int> results(8);
+    const double together = millisOf([&] {
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&, t] { results[static_cast<std::size_t>(t)] = cachedTask(21).get(); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    threads.clear();
+    std::cout << "\n8 concurrent callers for key 21: " << computations << " computation, " << together
+              << " ms, every result " << results[0] << "\n";
+    printStats("Memoized longRunningTask", cachedTask.underlyingCache().stats());
+
+    // Step 3: LRU eviction with room for 3 entries
+    TaskCache<int, int> small(3);
+    for (int key : {1, 2, 3, 1, 4, 5, 1}) {
+        small.get(key, [key] { return key * 10; }).get();
+    }
+    std::cout << "\nCapacity 3 after 1 2 3 1 4 5 1: " << small.size() << " entries, key 1 kept (recently used), keys"
+              << " 2 and 3 evicted\n";
+    printStats("Small cache", small.stats());
+
+    // Step 4: eviction by size. The cost of a result is its length in bytes; the cache keeps at most 4 KB.
+    TaskCache<int, std::string> bySize(1'000, 4096, [](const std::string& text) { return text.size(); });
+    for (int key = 0; key < 10; ++key) {
+        bySize.get(key, [key] { return std::string(static_cast<std::size_t>(100 * (key + 1)), 'x'); }).get();
+    }
+    std::cout << "\nSize-limited cache: " << bySize.size() << " entries, " << bySize.cost() << " bytes\n";
+
+    // Step 5: failures are not cached
+    TaskCache<std::string, int> flaky(10);
+    int attempts = 0;
+    std::cout << "\n";
+    for (int i = 0; i < 2; ++i) {
+        try {
+            const int value = flaky.get("config", [&attempts] {
+                if (++attempts == 1) {
+                    throw std::runtime_error("service unavailable");
+                }
+                return 42;
+            }).get();
+            std::cout << "Attempt " << attempts << " returned " << value << "\n";
+        } catch (const std::exception& e) {
+            std::cout << "Attempt " << attempts << " failed: " << e.what() << "\n";
+        }
+    }
+
+    // Step 6: hit rate and throughput against uncached deferred calls, for Zipf traffic over 10,000 keys. Each
+    // computation costs about 20 us.
+    auto expensive = [](int key) {
+        double x = key;
+        for (int i = 0; i < 2'000; ++i) {
+            x = std::sqrt(x + i);
+        }
+        return x;
+    };
+    constexpr int requests = 100'000;
+    std::cout << "\n" << requests << " Zipf requests over 10,000 keys, 4 threads:\n";
+    auto run = [&](auto lookup) {
+        std::vector<std::thread> workers;
+        const double millis = millisOf([&] {
+            for (int t = 0; t < 4; ++t) {
+                workers.emplace_back([&, t] {
+                    ZipfKeys keys(10'000, 1.0, static_cast<unsigned>(t + 1));
+                    double sink = 0;
+                    for (int i = 0; i < requests / 4; ++i) {
+                        sink += lookup(keys.next());
+                    }
+                    volatile double keep = sink;
+                    (void)keep;
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        });
+        return millis;
+    };
+    const double uncached = run([&](int key) { return std::async(std::launch::deferred, expensive, key).get(); });
+    std::cout << "  uncached std::launch::deferred: " << uncached << " ms\n";
+    for (std::size_t capacity : {100, 1'000, 10'000}) {
+        Memoized<double(int)> memo(expensive, capacity);
+        const double millis = run([&](int key) { return memo(key).get(); });
+        const TaskCacheStats stats = memo.underlyingCache().stats();
+        std::cout << "  capacity " << std::setw(6) << capacity << ": " << std::setw(8) << millis << " ms, hit rate "
+                  << std::setw(5) << 100.0 * stats.hitRate() << "%, " << stats.evictions << " evictions\n";
+    }
+
+    return 0;
+}
+
+/*
+Sample Output (timings vary by machine; these come from a single-core machine. The hit rates depend only on
+the key distribution and the capacity):
+std::launch::deferred, twice:
+  200.2 ms
+  200.1 ms
+Memoized, twice:
+  200.2 ms -> 10
+  0.0 ms -> 10
+
+8 concurrent callers for key 21: 1 computation, 201.0 ms, every result 42
+Memoized longRunningTask: 8 hits (7 joined a running computation), 2 misses, 0 evictions, 0 failures, hit rate 80.0%
+
+Capacity 3 after 1 2 3 1 4 5 1: 3 entries, key 1 kept (recently used), keys 2 and 3 evicted
+Small cache: 2 hits (0 joined a running computation), 5 misses, 2 evictions, 0 failures, hit rate 28.6%
+
+Size-limited cache: 5 entries, 4000 bytes
+
+Attempt 1 failed: service unavailable
+Attempt 2 returned 42
+
+100000 Zipf requests over 10,000 keys, 4 threads:
+  uncached std::launch::deferred: 1876.6 ms
+  capacity    100:   1195.8 ms, hit rate  39.2%, 60742 evictions
+  capacity   1000:    688.2 ms, hit rate  67.5%, 31508 evictions
+  capacity  10000:    216.0 ms, hit rate  91.5%, 0 evictions
+*/
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <iomanip>
+#include "TaskGraph.h"
+
+// Simulated work: the pool worker is busy for this long (sleeping keeps the benchmark meaningful on any core count)
+void simulateWork(int millis) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+}
+
+// Makespan of a graph run level by level: every task of a stage is started with std::async and the next stage
+// waits for all of them, like the condition_variable barrier in threads_example.cpp
+double levelByLevelMillis(const std::vector<std::vector<int>>& stages, unsigned workers) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& stage : stages) {
+        // At most `workers` tasks at a time, to compare against a pool of the same size
+        for (std::size_t first = 0; first < stage.size(); first += workers) {
+            std::vector<std::future<void>> running;
+            for (std::size_t i = first; i < std::min(stage.size(), first + workers); ++i) {
+                running.push_back(std::async(std::launch::async, simulateWork, stage[i]));
+            }
+            for (auto& f : running) {
+                f.get();
+            }
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Independent jobs, added first, and a chain of dependent steps, added last, so FIFO order reaches the chain late
+void buildMixedGraph(TaskGraph& graph, int independent, int chainLength, int millis) {
+    for (int i = 0; i < independent; ++i) {
+        graph.add("job " + std::to_string(i), [millis] { simulateWork(millis); }, millis);
+    }
+    TaskGraph::TaskId previous = graph.add("chain 0", [millis] { simulateWork(millis); }, millis);
+    for (int i = 1; i < chainLength; ++i) {
+        TaskGraph::TaskId next = graph.add("chain " + std::to_string(i), [millis] { simulateWork(millis); }, millis);
+        graph.precede(previous, next);
+        previous = next;
+    }
+}
+
+int main() {
+    WorkStealingPool pool(2);
+    TaskGraphExecutor executor(pool);
+
+    // Step 1: a small pipeline. "fetch B" only learns at run time how many chunks it has, so it builds a subgraph;
+    // "merge" still waits for every chunk.
+    std::atomic<int> a{0}, b{0};
+    int merged = 0;
+    TaskGraph pipeline;
+    auto config = pipeline.add("load config", [] { simulateWork(10); }, 10);
+    auto fetchA = pipeline.add("fetch A", [&a] { simulateWork(40); a = 1; }, 40);
+    auto fetchB = pipeline.addDynamic("fetch B", [&b](TaskGraph& chunks) {
+        const int chunkCount = 3; // e.g. read from a response header
+        for (int i = 0; i < chunkCount; ++i) {
+            chunks.add("chunk " + std::to_string(i), [&b] { simulateWork(20); b += 10; }, 20);
+        }
+    });
+    auto merge = pipeline.add("merge", [&] { merged = a + b; }, 1);
+    auto report = pipeline.add("report", [&merged] { std::cout << "Merged value: " << merged << std::endl; }, 1);
+    pipeline.precede(config, fetchA);
+    pipeline.precede(config, fetchB);
+    pipeline.precede(fetchA, merge);
+    pipeline.precede(fetchB, merge);
+    pipeline.precede(merge, report);
+
+    GraphTrace trace = executor.run(pipeline);
+    std::cout << "Pipeline finished in " << std::fixed << std::setprecision(0) << trace.makespanUs / 1000
+              << " ms, " << trace.events.size() << " tasks ran" << std::endl;
+    std::ofstream traceFile("task_graph_trace.json");
+    trace.writeChromeTrace(traceFile);
+    std::cout << "Trace written to task_graph_trace.json (open in chrome://tracing or ui.perfetto.dev)" << std::endl;
+    std::cout << "Graphviz of the last run:\n";
+    pipeline.writeDot(std::cout);
+
+    // Step 2: errors. A cycle is rejected before anything runs; an exception stops the tasks that have not started.
+    TaskGraph cyclic;
+    auto x = cyclic.add("x", [] {});
+    auto y = cyclic.add("y", [] {});
+    cyclic.precede(x, y);
+    cyclic.precede(y, x);
+    try {
+        executor.run(cyclic);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Rejected: " << e.what() << std::endl;
+    }
+    TaskGraph failing;
+    bool reportRan = false;
+    auto parse = failing.add("parse", [] { throw std::runtime_error("parse failed"); });
+    auto use = failing.add("use", [&reportRan] { reportRan = true; });
+    failing.precede(parse, use);
+    try {
+        executor.run(failing);
+    } catch (const std::exception& e) {
+        std::cout << "Run failed: " << e.what() << " (dependent task ran: " << std::boolalpha << reportRan << ")"
+                  << std::endl;
+    }
+
+    // Step 3: makespan of the same work under three schedules
+    constexpr int independent = 40, chainLength = 20, millis = 5;
+    TaskGraph mixed;
+    buildMixedGraph(mixed, independent, chainLength, millis);
+    const double criticalPathFirst = executor.run(mixed).makespanUs / 1000;
+    const double fifo = TaskGraphExecutor(pool, TaskGraphExecutor::Order::Fifo).run(mixed).makespanUs / 1000;
+
+    // Stage 0 holds every independent job and the head of the chain, then one stage per chain step
+    std::vector<std::vector<int>> stages(chainLength, std::vector<int>{millis});
+    stages[0].assign(independent + 1, millis);
+    const double barrier = levelByLevelMillis(stages, pool.size());
+
+    const double totalWork = (independent + chainLength) * millis;
+    std::cout << "\nBenchmark: " << independent << " independent " << millis << " ms jobs + a chain of " << chainLength
+              << " steps, " << pool.size() << " workers\n";
+    std::cout << "Lower bound (max of critical path, work / workers): "
+              << std::max<double>(chainLength * millis, totalWork / pool.size()) << " ms\n";
+    std::cout << "Task graph, critical path first: " << std::setw(6) << criticalPathFirst << " ms\n";
+    std::cout << "Task graph, FIFO ready order:    " << std::setw(6) << fifo << " ms\n";
+    std::cout << "Stage barriers with std::async:  " << std::setw(6) << barrier << " ms\n";
+
+    // Step 4: scheduling overhead per node with empty tasks
+    constexpr int tinyNodes = 100'000;
+    TaskGraph wide;
+    auto root = wide.add("root", [] {});
+    for (int i = 1; i < tinyNodes; ++i) {
+        wide.precede(root, wide.add("leaf", [] {}));
+    }
+    const double wideUs = executor.run(wide).makespanUs;
+    std::cout << "Overhead: " << wideUs * 1000 / tinyNodes << " ns per empty node (" << tinyNodes << " nodes)\n";
+
+    return 0;
+}
+
+/*
+Sample Output (benchmark numbers vary by machine; these come from a single-core machine):
+Merged value: 31
+Pipeline finished in 72 ms, 8 tasks ran
+Trace written to task_graph_trace.json (open in chrome://tracing or ui.perfetto.dev)
+Graphviz of the last run:
+digraph TaskGraph {
+  n0 [label="load config"];
+  n0 -> n1;
+  n0 -> n2;
+  n1 [label="fetch A"];
+  n1 -> n3;
+  n2 [label="fetch B" shape=box];
+  n2 -> n3;
+  subgraph cluster_n2 {
+  label="fetch B";
+  n2_0 [label="chunk 0"];
+  n2_1 [label="chunk 1"];
+  n2_2 [label="chunk 2"];
+  }
+  n2 -> n2_0 [style=dashed];
+  n2 -> n2_1 [style=dashed];
+  n2 -> n2_2 [style=dashed];
+  n3 [label="merge"];
+  n3 -> n4;
+  n4 [label="report"];
+}
+Rejected: TaskGraph contains a cycle
+Run failed: parse failed (dependent task ran: false)
+
+Benchmark: 40 independent 5 ms jobs + a chain of 20 steps, 2 workers
+Lower bound (max of critical path, work / workers): 150 ms
+Task graph, critical path first:    153 ms
+Task graph, FIFO ready order:       204 ms
+Stage barriers with std::async:     213 ms
+Overhead: 756 ns per empty node (100000 nodes)
+*/
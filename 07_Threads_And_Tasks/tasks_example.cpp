@@ -2,6 +2,7 @@
 #include <thread>
 #include <future>
 #include <chrono> // For std::chrono::seconds
+#include "WorkStealingPool.h" // Fixed-size thread pool, see thread_pool_example.cpp
 
 // Function to simulate a long-running task
 // This function takes an integer input, simulates a delay, and returns the input multiplied by 2.
@@ -39,5 +40,13 @@ int main() {
     // The task will not run until .get() or .wait() is called.
     std::cout << "Deferred task result: " << deferredResult.get() << std::endl;
 
+    // Example of a thread pool:
+    // std::launch::async creates (and destroys) one OS thread per task. A pool starts its threads once
+    // and reuses them, so submitting a task costs far less than starting a thread.
+    WorkStealingPool pool;
+    std::cout << "Starting pool task..." << std::endl;
+    std::future<int> pooledResult = pool.submit(longRunningTask, 20);
+    std::cout << "Pool task result: " << pooledResult.get() << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <vector>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <iomanip>
+#include "WorkStealingPool.h"
+
+// Function to simulate a long-running task (same as in tasks_example.cpp, with a shorter delay)
+int longRunningTask(int input) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return input * 2;
+}
+
+// Recursive Fibonacci that splits itself into pool tasks; shows tasks spawning tasks and idle workers stealing them
+long long parallelFib(WorkStealingPool& pool, int n) {
+    if (n < 25) {
+        long long a = 0, b = 1;
+        for (int i = 0; i < n; ++i) {
+            b = a + b;
+            a = b - a;
+        }
+        return a;
+    }
+    auto left = pool.submit(parallelFib, std::ref(pool), n - 1);
+    long long right = parallelFib(pool, n - 2);
+    // Never just block inside a worker: the awaited task may sit in this worker's own deque
+    while (left.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!pool.tryRunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+    return left.get() + right;
+}
+
+// Measures the cost of launching and completing many tiny tasks
+template <typename Launch>
+double nanosPerTask(int taskCount, Launch launch) {
+    auto start = std::chrono::steady_clock::now();
+    launch(taskCount);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / taskCount;
+}
+
+int tinyTask(int i) { return i + 1; }
+
+int main(int argc, char* argv[]) {
+    WorkStealingPool pool; // One worker per hardware thread
+
+    // Step 1: same usage as std::async, but no thread is created per task
+    std::cout << "Pool with " << pool.size() << " workers\n";
+    std::cout << "Starting pool task..." << std::endl;
+    std::future<int> result = pool.submit(longRunningTask, 10);
+    std::cout << "Doing other work..." << std::endl;
+    std::cout << "Result: " << result.get() << std::endl;
+
+    // Step 2: many tasks in flight at once
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 8; ++i) {
+        results.push_back(pool.submit(longRunningTask, i));
+    }
+    int sum = 0;
+    for (auto& r : results) {
+        sum += r.get();
+    }
+    std::cout << "Sum of 8 pool tasks: " << sum << "\n";
+
+    // Step 3: tasks that spawn tasks
+    std::cout << "fib(32) on the pool: " << pool.submit(parallelFib, std::ref(pool), 32).get() << "\n";
+
+    // Step 4: benchmark task-spawn overhead, 10^6 tiny tasks by default
+    const int taskCount = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+    std::cout << "\nBenchmark: " << taskCount << " tiny tasks\n";
+
+    const double asyncCost = nanosPerTask(taskCount, [](int count) {
+        // Keep a bounded window of futures so we do not hold a million threads at once
+        constexpr int window = 256;
+        std::vector<std::future<int>> futures;
+        futures.reserve(window);
+        for (int i = 0; i < count; ++i) {
+            futures.push_back(std::async(std::launch::async, tinyTask, i));
+            if (futures.size() == window) {
+                for (auto& f : futures) {
+                    f.get();
+                }
+                futures.clear();
+            }
+        }
+        for (auto& f : futures) {
+            f.get();
+        }
+    });
+
+    const double submitCost = nanosPerTask(taskCount, [&pool](int count) {
+        std::vector<std::future<int>> futures;
+        futures.reserve(static_cast<std::size_t>(count));
+        for (int i = 0; i < count; ++i) {
+            futures.push_back(pool.submit(tinyTask, i));
+        }
+        for (auto& f : futures) {
+            f.get();
+        }
+    });
+
+    const double postCost = nanosPerTask(taskCount, [&pool](int count) {
+        std::vector<int> values(static_cast<std::size_t>(count));
+        std::atomic<int> remaining{count};
+        for (int i = 0; i < count; ++i) {
+            pool.post([&values, &remaining, i] {
+                values[static_cast<std::size_t>(i)] = tinyTask(i);
+                if (remaining.fetch_sub(1) == 1) {
+                    remaining.notify_one(); // Last task wakes the submitter
+                }
+            });
+        }
+        int left;
+        while ((left = remaining.load()) != 0) {
+            remaining.wait(left);
+        }
+    });
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "std::async(launch::async): " << std::setw(8) << asyncCost << " ns/task\n";
+    std::cout << "pool.submit (std::future): " << std::setw(8) << submitCost << " ns/task ("
+              << std::setprecision(1) << asyncCost / submitCost << "x faster)\n";
+    std::cout << std::setprecision(0);
+    std::cout << "pool.post (no future):     " << std::setw(8) << postCost << " ns/task ("
+              << std::setprecision(1) << asyncCost / postCost << "x faster)\n";
+
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include <iostream>
+#include <vector>
+#include <map>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <algorithm>
+#include "TimerWheel.h"
+#include "Coroutines.h"
+
+using Clock = std::chrono::steady_clock;
+
+// co_await sleepOnWheel(...): the timer service only posts the coroutine back to the pool, so the
+// timer thread never runs user code
+struct WheelSleep {
+    TimerService& timers;
+    Scheduler& scheduler;
+    Clock::duration delay;
+    bool await_ready() const noexcept { return delay <= Clock::duration::zero(); }
+    void await_suspend(std::coroutine_handle<> handle) {
+        timers.schedule(delay, [&scheduler = scheduler, handle] { scheduler.resumeOnPool(handle); });
+    }
+    void await_resume() const noexcept {}
+};
+
+WheelSleep sleepOnWheel(TimerService& timers, Scheduler& scheduler, Clock::duration delay) {
+    return WheelSleep{timers, scheduler, delay};
+}
+
+// Same shape as longRunningTask in tasks_example.cpp, waiting on the wheel instead of blocking a thread
+Task<int> longRunningTask(TimerService& timers, Scheduler& scheduler, int input) {
+    co_await sleepOnWheel(timers, scheduler, std::chrono::milliseconds(200));
+    co_return input * 2;
+}
+
+Task<int> chainedTasks(TimerService& timers, Scheduler& scheduler) {
+    int first = co_await longRunningTask(timers, scheduler, 10);
+    co_return co_await longRunningTask(timers, scheduler, first);
+}
+
+template <typename F>
+double elapsedNanos(F&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+struct OperationCosts {
+    double insertNs = 0;
+    double cancelNs = 0;
+    double fireNs = 0;
+};
+
+// The wheel itself, without the service's mutex and thread
+OperationCosts benchmarkWheel(const std::vector<std::uint64_t>& expiries, const std::vector<std::size_t>& toCancel,
+                              std::uint64_t horizon, long& fired) {
+    TimerWheel wheel;
+    std::vector<TimerId> ids(expiries.size());
+    OperationCosts costs;
+
+    costs.insertNs = elapsedNanos([&] {
+        for (std::size_t i = 0; i < expiries.size(); ++i) {
+            ids[i] = wheel.schedule(expiries[i], [&fired] { ++fired; });
+        }
+    }) / static_cast<double>(expiries.size());
+
+    costs.cancelNs = elapsedNanos([&] {
+        for (std::size_t i : toCancel) {
+            wheel.cancel(ids[i]);
+        }
+    }) / static_cast<double>(toCancel.size());
+
+    const std::size_t remaining = wheel.size();
+    std::vector<TimerWheel::Callback> due;
+    costs.fireNs = elapsedNanos([&] {
+        for (std::uint64_t tick = 1; tick <= horizon; ++tick) {
+            wheel.advance(tick, due);
+            for (auto& callback : due) {
+                callback();
+            }
+            due.clear();
+        }
+    }) / static_cast<double>(remaining);
+    return costs;
+}
+
+// Ordered map of deadlines: O(log n) insert, erase by iterator for cancel
+OperationCosts benchmarkMultimap(const std::vector<std::uint64_t>& expiries, const std::vector<std::size_t>& toCancel,
+                                 std::uint64_t horizon, long& fired) {
+    std::multimap<std::uint64_t, TimerWheel::Callback> timers;
+    std::vector<std::multimap<std::uint64_t, TimerWheel::Callback>::iterator> handles(expiries.size());
+    OperationCosts costs;
+
+    costs.insertNs = elapsedNanos([&] {
+        for (std::size_t i = 0; i < expiries.size(); ++i) {
+            handles[i] = timers.emplace(expiries[i], [&fired] { ++fired; });
+        }
+    }) / static_cast<double>(expiries.size());
+
+    costs.cancelNs = elapsedNanos([&] {
+        for (std::size_t i : toCancel) {
+            timers.erase(handles[i]);
+        }
+    }) / static_cast<double>(toCancel.size());
+
+    const std::size_t remaining = timers.size();
+    costs.fireNs = elapsedNanos([&] {
+        for (std::uint64_t tick = 1; tick <= horizon; ++tick) {
+            while (!timers.empty() && timers.begin()->first <= tick) {
+                auto node = timers.extract(timers.begin());
+                node.mapped()();
+            }
+        }
+    }) / static_cast<double>(remaining);
+    return costs;
+}
+
+// Binary heap: O(log n) insert, no removal from the middle, so cancel only marks the timer and the heap
+// still pays to pop it later
+OperationCosts benchmarkHeap(const std::vector<std::uint64_t>& expiries, const std::vector<std::size_t>& toCancel,
+                             std::uint64_t horizon, long& fired) {
+    struct Entry {
+        std::uint64_t expiry;
+        std::size_t id;
+        TimerWheel::Callback callback;
+        bool operator>(const Entry& other) const { return expiry > other.expiry; }
+    };
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> timers;
+    std::vector<char> cancelled(expiries.size(), 0);
+    OperationCosts costs;
+
+    costs.insertNs = elapsedNanos([&] {
+        for (std::size_t i = 0; i < expiries.size(); ++i) {
+            timers.push({expiries[i], i, [&fired] { ++fired; }});
+        }
+    }) / static_cast<double>(expiries.size());
+
+    costs.cancelNs = elapsedNanos([&] {
+        for (std::size_t i : toCancel) {
+            cancelled[i] = 1;
+        }
+    }) / static_cast<double>(toCancel.size());
+
+    const std::size_t remaining = expiries.size() - toCancel.size();
+    costs.fireNs = elapsedNanos([&] {
+        for (std::uint64_t tick = 1; tick <= horizon; ++tick) {
+            while (!timers.empty() && timers.top().expiry <= tick) {
+                if (!cancelled[timers.top().id]) {
+                    timers.top().callback();
+                }
+                timers.pop();
+            }
+        }
+    }) / static_cast<double>(remaining);
+    return costs;
+}
+
+void printCosts(const char* name, const OperationCosts& costs, long fired) {
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(11) << costs.insertNs << std::setw(11) << costs.cancelNs << std::setw(11) << costs.fireNs
+              << std::setw(10) << fired << "\n";
+}
+
+struct Jitter {
+    double p50Us;
+    double p99Us;
+    double maxUs;
+};
+
+Jitter percentiles(std::vector<double> latenessUs) {
+    std::sort(latenessUs.begin(), latenessUs.end());
+    auto at = [&](double q) {
+        return latenessUs[static_cast<std::size_t>(q * static_cast<double>(latenessUs.size() - 1))];
+    };
+    return {at(0.50), at(0.99), latenessUs.back()};
+}
+
+int main(int argc, char* argv[]) {
+    // Step 1: callbacks, including one cancelled before it fires
+    {
+        TimerService timers;
+        std::mutex printMutex;
+        auto say = [&printMutex](const char* text) {
+            std::lock_guard<std::mutex> lock(printMutex);
+            std::cout << text << std::endl;
+        };
+        timers.schedule(std::chrono::milliseconds(150), [&] { say("Timer at 150 ms fired"); });
+        timers.schedule(std::chrono::milliseconds(50), [&] { say("Timer at 50 ms fired"); });
+        TimerId cancelled = timers.schedule(std::chrono::milliseconds(100), [&] { say("Never printed"); });
+        std::cout << "Cancelled the 100 ms timer: " << std::boolalpha << timers.cancel(cancelled) << std::endl;
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        std::cout << "Cancelling it again: " << timers.cancel(cancelled) << std::endl;
+    }
+
+    // Step 2: coroutines suspended on the wheel and resumed on the pool
+    WorkStealingPool pool(2);
+    Scheduler scheduler(pool);
+    TimerService timers;
+    const auto chainStart = Clock::now();
+    const int chainResult = scheduler.blockOn(chainedTasks(timers, scheduler));
+    std::cout << "Coroutine chain result: " << chainResult << " after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - chainStart).count() << " ms"
+              << std::endl;
+
+    // Step 3: cost per operation with many outstanding timers (single thread, no locking)
+    const std::size_t timerCount = argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 1'000'000;
+    const std::uint64_t horizon = 600'000; // Ten minutes of 1 ms ticks
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<std::uint64_t> delay(1, horizon);
+    std::vector<std::uint64_t> expiries(timerCount);
+    for (auto& expiry : expiries) {
+        expiry = delay(random);
+    }
+    std::vector<std::size_t> toCancel(timerCount);
+    for (std::size_t i = 0; i < timerCount; ++i) {
+        toCancel[i] = i;
+    }
+    std::shuffle(toCancel.begin(), toCancel.end(), random);
+    toCancel.resize(timerCount / 2); // Most timeouts in a server are cancelled before they fire
+
+    std::cout << "\nBenchmark: " << timerCount << " timers over " << horizon << " ticks, half cancelled\n";
+    std::cout << std::left << std::setw(28) << "structure" << std::right << std::setw(11) << "insert ns"
+              << std::setw(11) << "cancel ns" << std::setw(11) << "fire ns" << std::setw(10) << "fired" << "\n";
+    long wheelFired = 0, multimapFired = 0, heapFired = 0;
+    const OperationCosts wheel = benchmarkWheel(expiries, toCancel, horizon, wheelFired);
+    const OperationCosts multimap = benchmarkMultimap(expiries, toCancel, horizon, multimapFired);
+    const OperationCosts heap = benchmarkHeap(expiries, toCancel, horizon, heapFired);
+    printCosts("TimerWheel", wheel, wheelFired);
+    printCosts("std::multimap", multimap, multimapFired);
+    printCosts("priority_queue (lazy cancel)", heap, heapFired);
+
+    // Step 4: how late timers fire through TimerService while many others are outstanding
+    constexpr int probes = 2'000;
+    std::vector<TimerId> background;
+    background.reserve(timerCount);
+    for (std::size_t i = 0; i < timerCount; ++i) {
+        background.push_back(timers.schedule(std::chrono::hours(1), [] {}));
+    }
+    std::vector<double> latenessUs(probes);
+    std::atomic<int> remaining{probes};
+    for (int i = 0; i < probes; ++i) {
+        const auto deadline = Clock::now() + std::chrono::microseconds(500 + 1'000 * (i % 1'000));
+        timers.scheduleAt(deadline, [&latenessUs, &remaining, deadline, i] {
+            latenessUs[static_cast<std::size_t>(i)] =
+                std::chrono::duration<double, std::micro>(Clock::now() - deadline).count();
+            if (remaining.fetch_sub(1) == 1) {
+                remaining.notify_one();
+            }
+        });
+    }
+    int left;
+    while ((left = remaining.load()) != 0) {
+        remaining.wait(left);
+    }
+    const Jitter jitter = percentiles(latenessUs);
+    std::cout << "\nFiring delay after the deadline (" << probes << " timers, " << timers.size()
+              << " outstanding, 1 ms tick): p50 " << std::setprecision(0) << jitter.p50Us << " us, p99 "
+              << jitter.p99Us << " us, max " << jitter.maxUs << " us\n";
+    for (TimerId id : background) {
+        timers.cancel(id);
+    }
+
+    return 0;
+}
+
+/*
+Sample Output (numbers vary by machine; these come from a single-core machine. The wheel's "fire" cost includes
+stepping through all 600000 ticks and cascading, and timers fire up to one tick late by design):
+Cancelled the 100 ms timer: true
+Timer at 50 ms fired
+Timer at 150 ms fired
+Cancelling it again: false
+Coroutine chain result: 40 after 402 ms
+
+Benchmark: 1000000 timers over 600000 ticks, half cancelled
+structure                     insert ns  cancel ns    fire ns     fired
+TimerWheel                         78.4       78.5      365.7    500000
+std::multimap                    1379.1      500.8      177.6    500000
+priority_queue (lazy cancel)       66.3        2.9     1024.4    500000
+
+Firing delay after the deadline (2000 timers, 1000000 outstanding, 1 ms tick): p50 920 us, p99 2773 us, max 8348 us
+*/
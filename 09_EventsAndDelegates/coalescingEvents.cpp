@@ -0,0 +1,269 @@
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+// This example extends the Event class from eventsAndDelegates.cpp for "value changed" style events.
+// Events like onValueChanged can fire thousands of times per second, but a UI label or a metrics exporter only
+// cares about the most recent value. Calling every listener for every intermediate value wastes CPU.
+//
+// The CoalescingEvent below works in two phases:
+// 1. post(key, value) only records the latest value for that key. Posting the same key twice before the next
+//    dispatch overwrites the older value (the intermediate value is "coalesced" away).
+// 2. dispatch() is called periodically (a "tick", e.g. once per frame). It hands each listener the latest value of
+//    every key that changed since the listener was last served.
+//
+// Each listener can also have a maximum delivery rate (deliveries per second). A rate-limited listener that is not
+// due yet keeps accumulating the latest values and is served on a later tick, so it never sees stale values and
+// never falls behind.
+//
+// In C#, the closest equivalent is throttling an event with Reactive Extensions (Observable.Sample/Throttle).
+
+template <typename Key, typename Payload>
+class CoalescingEvent {
+public:
+    using Callback = std::function<void(const Key&, const Payload&)>;
+    using Clock = std::chrono::steady_clock;
+
+    // Add a listener; maxDeliveriesPerSecond == 0 means "deliver on every tick"
+    void addListener(const std::shared_ptr<Callback>& listener, double maxDeliveriesPerSecond = 0.0) {
+        ListenerState state;
+        state.callback = listener;
+        if (maxDeliveriesPerSecond > 0.0) {
+            state.minInterval = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / maxDeliveriesPerSecond));
+        }
+        std::lock_guard<std::mutex> lock(listenersMutex); // Ensure thread-safety
+        listeners.push_back(std::move(state));
+    }
+
+    // Remove a listener from the event
+    void removeListener(const std::shared_ptr<Callback>& listener) {
+        std::lock_guard<std::mutex> lock(listenersMutex); // Ensure thread-safety
+        listeners.erase(
+            std::remove_if(listeners.begin(), listeners.end(),
+                           [&listener](const ListenerState& state) {
+                               return state.callback.lock() == listener;
+                           }),
+            listeners.end());
+    }
+
+    // Record the latest value for a key; cheap enough to call from hot paths
+    void post(const Key& key, const Payload& value) {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        auto [it, inserted] = pending.try_emplace(key, value);
+        if (!inserted) {
+            it->second = value; // Overwrite the intermediate value
+            ++coalescedCount;
+        }
+        ++postedCount;
+    }
+
+    // Deliver the latest values to every listener that is due; returns the number of callbacks invoked
+    std::size_t dispatch(Clock::time_point now = Clock::now()) {
+        // Swap the pending values out so producers are never blocked by slow listeners
+        std::unordered_map<Key, Payload> batch;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            batch.swap(pending);
+        }
+
+        std::size_t delivered = 0;
+        std::lock_guard<std::mutex> lock(listenersMutex);
+        for (auto& state : listeners) {
+            auto listener = state.callback.lock(); // Check if the listener is still valid
+            if (!listener) {
+                continue;
+            }
+
+            const bool due = now >= state.nextAllowed;
+            std::size_t deliveredToListener = 0;
+            if (due && state.held.empty()) {
+                // Fast path: nothing held back, deliver straight from the batch without copying
+                for (const auto& [key, value] : batch) {
+                    (*listener)(key, value);
+                    ++deliveredToListener;
+                }
+            } else {
+                for (const auto& [key, value] : batch) {
+                    state.held.insert_or_assign(key, value); // Keep only the latest value per key
+                }
+                if (due) {
+                    for (const auto& [key, value] : state.held) {
+                        (*listener)(key, value);
+                        ++deliveredToListener;
+                    }
+                    state.held.clear();
+                }
+            }
+
+            // The rate limit only starts counting once the listener actually received something
+            if (deliveredToListener > 0 && state.minInterval != Clock::duration::zero()) {
+                state.nextAllowed = now + state.minInterval;
+            }
+            delivered += deliveredToListener;
+        }
+
+        // Forget listeners that were destroyed
+        listeners.erase(
+            std::remove_if(listeners.begin(), listeners.end(),
+                           [](const ListenerState& state) { return state.callback.expired(); }),
+            listeners.end());
+
+        deliveredCount += delivered;
+        return delivered;
+    }
+
+    std::size_t posted() const { return postedCount.load(); }
+    std::size_t coalesced() const { return coalescedCount.load(); }
+    std::size_t delivered() const { return deliveredCount.load(); }
+
+private:
+    struct ListenerState {
+        std::weak_ptr<Callback> callback;
+        Clock::duration minInterval = Clock::duration::zero();
+        Clock::time_point nextAllowed{};
+        std::unordered_map<Key, Payload> held; // Latest values waiting for a rate-limited listener
+    };
+
+    std::mutex pendingMutex; // Guards pending; held only for a map insert
+    std::unordered_map<Key, Payload> pending;
+
+    std::mutex listenersMutex; // Guards listeners; held while callbacks run
+    std::vector<ListenerState> listeners;
+
+    std::atomic<std::size_t> postedCount{0};
+    std::atomic<std::size_t> coalescedCount{0};
+    std::atomic<std::size_t> deliveredCount{0};
+};
+
+// Demonstrates coalescing with a manual clock so the output is deterministic
+void demonstrateCoalescing() {
+    using Clock = CoalescingEvent<std::string, int>::Clock;
+    CoalescingEvent<std::string, int> onValueChanged;
+
+    auto uiCallback = std::make_shared<CoalescingEvent<std::string, int>::Callback>(
+        [](const std::string& key, int value) {
+            std::cout << "  UI label '" << key << "' shows " << value << "\n";
+        });
+    auto metricsCallback = std::make_shared<CoalescingEvent<std::string, int>::Callback>(
+        [](const std::string& key, int value) {
+            std::cout << "  Metrics exporter sends " << key << "=" << value << "\n";
+        });
+
+    onValueChanged.addListener(uiCallback);            // Every tick
+    onValueChanged.addListener(metricsCallback, 1.0);  // At most once per second
+
+    auto now = Clock::time_point{};
+    for (int tick = 0; tick < 3; ++tick) {
+        // Many updates between two ticks; only the last value per key survives
+        for (int i = 1; i <= 1000; ++i) {
+            onValueChanged.post("temperature", tick * 1000 + i);
+        }
+        onValueChanged.post("pressure", 100 + tick);
+
+        std::cout << "Tick " << tick << ":\n";
+        onValueChanged.dispatch(now);
+        now += std::chrono::milliseconds(500); // Ticks every 500 ms, metrics is due every other tick
+    }
+
+    std::cout << "Posted: " << onValueChanged.posted()
+              << ", coalesced away: " << onValueChanged.coalesced()
+              << ", callbacks invoked: " << onValueChanged.delivered() << "\n";
+}
+
+// Measures how many callbacks a slow listener receives with and without coalescing
+void benchmarkCoalescing() {
+    constexpr int updates = 1'000'000;
+    constexpr auto tickInterval = std::chrono::milliseconds(16); // ~60 ticks per second
+
+    // Simulated slow listener work (e.g. re-rendering a widget)
+    auto slowWork = [](int value) {
+        volatile int sink = 0;
+        for (int i = 0; i < 200; ++i) {
+            sink = sink + value;
+        }
+    };
+
+    // Baseline: every update calls the listener directly, like Event::trigger
+    auto start = std::chrono::steady_clock::now();
+    std::size_t directCalls = 0;
+    for (int i = 0; i < updates; ++i) {
+        slowWork(i);
+        ++directCalls;
+    }
+    auto directElapsed = std::chrono::steady_clock::now() - start;
+
+    // Coalescing: a producer thread posts, the main thread ticks
+    CoalescingEvent<std::string, int> onValueChanged;
+    std::size_t coalescedCalls = 0;
+    auto slowListener = std::make_shared<CoalescingEvent<std::string, int>::Callback>(
+        [&](const std::string&, int value) {
+            slowWork(value);
+            ++coalescedCalls;
+        });
+    onValueChanged.addListener(slowListener, 30.0); // Slow consumer only wants 30 updates per second
+
+    std::atomic<bool> done{false};
+    start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (int i = 0; i < updates; ++i) {
+            onValueChanged.post("value", i);
+        }
+        done = true;
+    });
+    while (!done) {
+        onValueChanged.dispatch();
+        std::this_thread::sleep_for(tickInterval);
+    }
+    producer.join();
+    onValueChanged.dispatch(std::chrono::steady_clock::now() + std::chrono::seconds(1)); // Flush the last value
+    auto coalescedElapsed = std::chrono::steady_clock::now() - start;
+
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    std::cout << "Direct delivery:     " << directCalls << " listener calls in "
+              << duration_cast<milliseconds>(directElapsed).count() << " ms\n";
+    std::cout << "Coalesced delivery:  " << coalescedCalls << " listener calls in "
+              << duration_cast<milliseconds>(coalescedElapsed).count() << " ms (producer + ticks)\n";
+}
+
+int main() {
+    std::cout << "=== Coalescing event ===\n";
+    demonstrateCoalescing();
+
+    std::cout << "\n=== Benchmark: 1,000,000 updates, slow listener ===\n";
+    benchmarkCoalescing();
+
+    return 0;
+}
+
+/*
+Sample Output (benchmark numbers vary by machine):
+=== Coalescing event ===
+Tick 0:
+  UI label 'pressure' shows 100
+  UI label 'temperature' shows 1000
+  Metrics exporter sends pressure=100
+  Metrics exporter sends temperature=1000
+Tick 1:
+  UI label 'pressure' shows 101
+  UI label 'temperature' shows 2000
+Tick 2:
+  UI label 'pressure' shows 102
+  UI label 'temperature' shows 3000
+  Metrics exporter sends temperature=3000
+  Metrics exporter sends pressure=102
+Posted: 3003, coalesced away: 2997, callbacks invoked: 10
+
+=== Benchmark: 1,000,000 updates, slow listener ===
+Direct delivery:     1000000 listener calls in 488 ms
+Coalesced delivery:  3 listener calls in 65 ms (producer + ticks)
+*/
@@ -0,0 +1,346 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <iomanip>
+
+// Event (eventsAndDelegates.cpp) calls listeners strictly in insertion order, and EventManager
+// (10_Modern_CPP/02_smart_pointers_aprofundado.cpp) fires every event on the caller's thread with no notion of urgency.
+// This example adds priorities at both levels:
+//
+// 1. Listener priority: PriorityEvent keeps its listeners sorted by priority, so e.g. a risk check always runs before
+//    a logger. Listeners with the same priority keep their insertion order.
+// 2. Event priority: AsyncEventDispatcher queues events and delivers them on its own thread. Each priority level has
+//    its own FIFO queue and the dispatcher always serves the most urgent non-empty queue first, so a high-priority
+//    event does not wait behind thousands of queued bulk events.
+// 3. Starvation protection: once the oldest lower-priority event has waited longer than maxWait, it gets one delivery
+//    slot after every few higher-priority events, so a steady stream of high-priority events can slow bulk events
+//    down but never block them forever.
+//
+// In C#, this is similar to a Channel per priority drained by one consumer, or a PriorityQueue<TElement, TPriority>
+// (.NET 6+) with aging.
+
+enum class Priority { High = 0, Normal = 1, Bulk = 2 };
+constexpr std::size_t priorityLevels = 3;
+
+// Event with listeners ordered by priority instead of insertion order
+class PriorityEvent {
+public:
+    using Callback = std::function<void(int)>;
+
+    void addListener(const std::shared_ptr<Callback>& listener, Priority priority = Priority::Normal) {
+        std::lock_guard<std::mutex> lock(mutex); // Ensure thread-safety
+        // upper_bound keeps insertion order among listeners of the same priority
+        auto position = std::upper_bound(listeners.begin(), listeners.end(), priority,
+                                         [](Priority p, const Entry& entry) { return p < entry.priority; });
+        listeners.insert(position, {priority, listener});
+    }
+
+    void removeListener(const std::shared_ptr<Callback>& listener) {
+        std::lock_guard<std::mutex> lock(mutex); // Ensure thread-safety
+        listeners.erase(
+            std::remove_if(listeners.begin(), listeners.end(),
+                           [&listener](const Entry& entry) { return entry.callback.lock() == listener; }),
+            listeners.end());
+    }
+
+    void trigger(int value) const {
+        std::lock_guard<std::mutex> lock(mutex); // Ensure thread-safety
+        for (const auto& entry : listeners) {
+            if (auto listener = entry.callback.lock()) { // Check if the listener is still valid
+                (*listener)(value);
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        Priority priority;
+        std::weak_ptr<Callback> callback;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> listeners; // Sorted by priority
+};
+
+// EventManager-style dispatcher (string event type, string payload) that delivers on its own thread
+class AsyncEventDispatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void(const std::string&)>;
+
+    // prioritize == false turns the dispatcher into a single FIFO, used as the baseline in the benchmark
+    explicit AsyncEventDispatcher(std::chrono::microseconds maxWait = std::chrono::milliseconds(50),
+                                  bool prioritize = true)
+        : maxWait(maxWait), prioritize(prioritize), worker([this] { run(); }) {}
+
+    ~AsyncEventDispatcher() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_one();
+        worker.join();
+    }
+
+    void subscribe(const std::string& eventType, const std::shared_ptr<Callback>& callback,
+                   Priority listenerPriority = Priority::Normal) {
+        std::lock_guard<std::mutex> lock(subscribersMutex);
+        auto& list = subscribers[eventType];
+        auto position = std::upper_bound(list.begin(), list.end(), listenerPriority,
+                                         [](Priority p, const Subscriber& s) { return p < s.priority; });
+        list.insert(position, {listenerPriority, callback});
+    }
+
+    // Queue an event; returns immediately
+    void post(const std::string& eventType, std::string eventData, Priority priority = Priority::Normal) {
+        const std::size_t level = prioritize ? static_cast<std::size_t>(priority) : 0;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queues[level].push_back({eventType, std::move(eventData), Clock::now()});
+        }
+        queueReady.notify_one();
+    }
+
+    // Block until every queued event was delivered
+    void drain() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueIdle.wait(lock, [this] { return queuedCount() == 0 && !delivering; });
+    }
+
+    std::size_t starvationRescues() const { return rescues.load(); }
+
+private:
+    struct Subscriber {
+        Priority priority;
+        std::weak_ptr<Callback> callback;
+    };
+
+    struct QueuedEvent {
+        std::string type;
+        std::string data;
+        Clock::time_point enqueued;
+    };
+
+    std::size_t queuedCount() const {
+        std::size_t count = 0;
+        for (const auto& queue : queues) {
+            count += queue.size();
+        }
+        return count;
+    }
+
+    // Choose the queue to serve next; caller holds queueMutex and at least one queue is non-empty
+    std::size_t pickLevel(Clock::time_point now) {
+        std::size_t top = 0;
+        while (queues[top].empty()) {
+            ++top;
+        }
+
+        // Starvation protection: the oldest overdue event below the top level gets one slot after every
+        // burstLimit events from above, so urgent events stay fast even while a bulk backlog is overdue
+        std::size_t overdueLevel = priorityLevels;
+        for (std::size_t level = top + 1; level < priorityLevels; ++level) {
+            if (!queues[level].empty() && now - queues[level].front().enqueued > maxWait &&
+                (overdueLevel == priorityLevels ||
+                 queues[level].front().enqueued < queues[overdueLevel].front().enqueued)) {
+                overdueLevel = level;
+            }
+        }
+        if (overdueLevel != priorityLevels && servedSinceRescue >= burstLimit) {
+            servedSinceRescue = 0;
+            ++rescues;
+            return overdueLevel;
+        }
+        ++servedSinceRescue;
+        return top;
+    }
+
+    void run() {
+        for (;;) {
+            QueuedEvent event;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                delivering = false;
+                if (queuedCount() == 0) {
+                    queueIdle.notify_all();
+                }
+                queueReady.wait(lock, [this] { return stopping || queuedCount() != 0; });
+                if (queuedCount() == 0) {
+                    return; // Stopping and nothing left to deliver
+                }
+                auto& queue = queues[pickLevel(Clock::now())];
+                event = std::move(queue.front());
+                queue.pop_front();
+                delivering = true;
+            }
+
+            std::lock_guard<std::mutex> lock(subscribersMutex);
+            auto it = subscribers.find(event.type);
+            if (it == subscribers.end()) {
+                continue;
+            }
+            for (const auto& subscriber : it->second) {
+                if (auto callback = subscriber.callback.lock()) {
+                    (*callback)(event.data);
+                }
+            }
+        }
+    }
+
+    static constexpr std::size_t burstLimit = 8;
+    const std::chrono::microseconds maxWait;
+    const bool prioritize;
+    std::size_t servedSinceRescue = 0; // Only touched by the dispatcher thread
+
+    std::mutex subscribersMutex; // Guards subscribers; held while callbacks run
+    std::unordered_map<std::string, std::vector<Subscriber>> subscribers;
+
+    std::mutex queueMutex; // Guards queues, delivering and stopping
+    std::condition_variable queueReady;
+    std::condition_variable queueIdle;
+    std::array<std::deque<QueuedEvent>, priorityLevels> queues;
+    bool delivering = false;
+    bool stopping = false;
+    std::atomic<std::size_t> rescues{0};
+
+    std::thread worker; // Declared last so it starts after every other member is initialized
+};
+
+void demonstrateListenerPriority() {
+    PriorityEvent onOrder;
+    auto logger = std::make_shared<PriorityEvent::Callback>([](int id) { std::cout << "  [Bulk]   logger saw order " << id << "\n"; });
+    auto risk = std::make_shared<PriorityEvent::Callback>([](int id) { std::cout << "  [High]   risk check for order " << id << "\n"; });
+    auto ui = std::make_shared<PriorityEvent::Callback>([](int id) { std::cout << "  [Normal] UI shows order " << id << "\n"; });
+
+    // Added in "wrong" order on purpose
+    onOrder.addListener(logger, Priority::Bulk);
+    onOrder.addListener(ui, Priority::Normal);
+    onOrder.addListener(risk, Priority::High);
+
+    std::cout << "Triggering order 7:\n";
+    onOrder.trigger(7);
+}
+
+void demonstrateEventPriority() {
+    AsyncEventDispatcher dispatcher;
+    std::mutex coutMutex;
+    auto printer = std::make_shared<AsyncEventDispatcher::Callback>([&coutMutex](const std::string& data) {
+        std::lock_guard<std::mutex> lock(coutMutex);
+        std::cout << "  delivered: " << data << "\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Slow listener so the queues fill up
+    });
+    dispatcher.subscribe("update", printer);
+
+    for (int i = 1; i <= 3; ++i) {
+        dispatcher.post("update", "bulk report " + std::to_string(i), Priority::Bulk);
+    }
+    dispatcher.post("update", "normal refresh", Priority::Normal);
+    dispatcher.post("update", "HIGH: circuit breaker tripped", Priority::High);
+    dispatcher.drain();
+}
+
+// Measures enqueue-to-delivery latency of high-priority events while a producer floods bulk events
+void benchmarkTailLatency(bool prioritize) {
+    using Clock = AsyncEventDispatcher::Clock;
+    constexpr int bulkEvents = 200'000;
+    constexpr int highEvents = 2'000;
+
+    std::vector<double> highLatencies;
+    highLatencies.reserve(highEvents);
+    double worstBulkMicros = 0;
+    std::size_t rescues = 0;
+    {
+        AsyncEventDispatcher dispatcher(std::chrono::milliseconds(20), prioritize);
+
+        auto bulkListener = std::make_shared<AsyncEventDispatcher::Callback>([](const std::string& data) {
+            volatile std::size_t sink = 0;
+            for (int i = 0; i < 1000; ++i) {
+                sink = sink + data.size(); // Simulated work per bulk event, about a microsecond
+            }
+        });
+        auto highListener = std::make_shared<AsyncEventDispatcher::Callback>([&highLatencies](const std::string& data) {
+            const auto sent = Clock::time_point(Clock::duration(std::stoll(data)));
+            highLatencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+        });
+        Clock::time_point lastBulkSent;
+        auto lastBulkListener = std::make_shared<AsyncEventDispatcher::Callback>([&](const std::string&) {
+            worstBulkMicros = std::chrono::duration<double, std::micro>(Clock::now() - lastBulkSent).count();
+        });
+        dispatcher.subscribe("bulk", bulkListener);
+        dispatcher.subscribe("high", highListener);
+        dispatcher.subscribe("lastBulk", lastBulkListener);
+
+        std::thread flood([&] {
+            for (int i = 0; i < bulkEvents; ++i) {
+                dispatcher.post("bulk", "row " + std::to_string(i), Priority::Bulk);
+            }
+            lastBulkSent = Clock::now();
+            dispatcher.post("lastBulk", "", Priority::Bulk);
+        });
+        for (int i = 0; i < highEvents; ++i) {
+            dispatcher.post("high", std::to_string(Clock::now().time_since_epoch().count()), Priority::High);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        flood.join();
+        dispatcher.drain();
+        rescues = dispatcher.starvationRescues();
+    }
+
+    std::sort(highLatencies.begin(), highLatencies.end());
+    auto percentile = [&highLatencies](double p) {
+        return highLatencies[static_cast<std::size_t>(p / 100.0 * static_cast<double>(highLatencies.size() - 1))];
+    };
+    std::cout << std::left << std::setw(22) << (prioritize ? "Multi-level queues" : "Single FIFO") << std::right
+              << std::fixed << std::setprecision(1) << std::setw(10) << percentile(50) << std::setw(12)
+              << percentile(99) << std::setw(12) << percentile(99.9) << std::setw(16) << worstBulkMicros / 1000.0
+              << std::setw(10) << rescues << "\n";
+}
+
+int main() {
+    std::cout << "=== Listener priority ===\n";
+    demonstrateListenerPriority();
+
+    std::cout << "\n=== Event priority (slow listener, events posted Bulk x3, Normal, High) ===\n";
+    demonstrateEventPriority();
+
+    std::cout << "\n=== Benchmark: high-priority latency under a 200,000 event bulk flood ===\n";
+    std::cout << std::left << std::setw(22) << "dispatcher" << std::right << std::setw(10) << "p50 us"
+              << std::setw(12) << "p99 us" << std::setw(12) << "p99.9 us" << std::setw(16) << "last bulk ms"
+              << std::setw(10) << "rescues" << "\n";
+    benchmarkTailLatency(false);
+    benchmarkTailLatency(true);
+
+    return 0;
+}
+
+/*
+Sample Output (the first bulk event may be picked up before the others are queued; benchmark numbers vary by machine):
+=== Listener priority ===
+Triggering order 7:
+  [High]   risk check for order 7
+  [Normal] UI shows order 7
+  [Bulk]   logger saw order 7
+
+=== Event priority (slow listener, events posted Bulk x3, Normal, High) ===
+  delivered: bulk report 1
+  delivered: HIGH: circuit breaker tripped
+  delivered: normal refresh
+  delivered: bulk report 2
+  delivered: bulk report 3
+
+=== Benchmark: high-priority latency under a 200,000 event bulk flood ===
+dispatcher                p50 us      p99 us    p99.9 us    last bulk ms   rescues
+Single FIFO              74042.8    109420.7    110567.9           110.7         0
+Multi-level queues           6.5      1505.5      2793.2           103.5      1247
+*/